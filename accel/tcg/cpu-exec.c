@@ -243,6 +243,35 @@ static TranslationBlock *tb_htable_lookup(CPUState *cpu, target_ulong pc,
     return qht_lookup_custom(&tb_ctx.htable, &desc, h, tb_lookup_cmp);
 }
 
+/*
+ * Translate the TB at @pc after a lookup has missed.
+ *
+ * In user-mode, translation is serialized by mmap_lock.  When many
+ * threads run into the same cold code at once, all but the first queue
+ * up on the lock, and each would then translate the block again only
+ * for tb_link_page to discard the copy in favour of the one already in
+ * the hash table.  Look again once the lock is held, so that waiters
+ * pick up the published TB and the lock is released as soon as possible.
+ * In system-mode mmap_lock is a no-op and translation is only serialized
+ * per physical page, so the extra lookup is skipped.
+ */
+static TranslationBlock *tb_find_or_gen_code(CPUState *cpu, target_ulong pc,
+                                             target_ulong cs_base,
+                                             uint32_t flags, uint32_t cflags)
+{
+    TranslationBlock *tb = NULL;
+
+    mmap_lock();
+#ifdef CONFIG_USER_ONLY
+    tb = tb_htable_lookup(cpu, pc, cs_base, flags, cflags);
+#endif
+    if (tb == NULL) {
+        tb = tb_gen_code(cpu, pc, cs_base, flags, cflags);
+    }
+    mmap_unlock();
+    return tb;
+}
+
 /* Might cause an exception, so have a longjmp destination ready */
 static inline TranslationBlock *tb_lookup(CPUState *cpu, target_ulong pc,
                                           target_ulong cs_base,
@@ -536,9 +565,7 @@ void cpu_exec_step_atomic(CPUState *cpu)
 
         tb = tb_lookup(cpu, pc, cs_base, flags, cflags);
         if (tb == NULL) {
-            mmap_lock();
-            tb = tb_gen_code(cpu, pc, cs_base, flags, cflags);
-            mmap_unlock();
+            tb = tb_find_or_gen_code(cpu, pc, cs_base, flags, cflags);
         }
 
         cpu_exec_enter(cpu);
@@ -1002,9 +1029,7 @@ int cpu_exec(CPUState *cpu)
             if (tb == NULL) {
                 uint32_t h;
 
-                mmap_lock();
-                tb = tb_gen_code(cpu, pc, cs_base, flags, cflags);
-                mmap_unlock();
+                tb = tb_find_or_gen_code(cpu, pc, cs_base, flags, cflags);
                 /*
                  * We add the TB in the virtual pc hash table
                  * for the fast lookup
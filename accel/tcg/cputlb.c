@@ -315,10 +315,11 @@ static void flush_all_helper(CPUState *src, run_on_cpu_func fn,
     }
 }
 
-void tlb_flush_counts(size_t *pfull, size_t *ppart, size_t *pelide)
+void tlb_flush_counts(size_t *pfull, size_t *ppart, size_t *pelide,
+                      size_t *pmerged)
 {
     CPUState *cpu;
-    size_t full = 0, part = 0, elide = 0;
+    size_t full = 0, part = 0, elide = 0, merged = 0;
 
     CPU_FOREACH(cpu) {
         CPUArchState *env = cpu->env_ptr;
@@ -326,10 +327,27 @@ void tlb_flush_counts(size_t *pfull, size_t *ppart, size_t *pelide)
         full += qatomic_read(&env_tlb(env)->c.full_flush_count);
         part += qatomic_read(&env_tlb(env)->c.part_flush_count);
         elide += qatomic_read(&env_tlb(env)->c.elide_flush_count);
+        merged += qatomic_read(&env_tlb(env)->c.merged_flush_count);
     }
     *pfull = full;
     *ppart = part;
     *pelide = elide;
+    *pmerged = merged;
+}
+
+void tlb_miss_counts(int mmu_idx, size_t *pvhit, size_t *pmiss)
+{
+    CPUState *cpu;
+    size_t vhit = 0, miss = 0;
+
+    CPU_FOREACH(cpu) {
+        CPUArchState *env = cpu->env_ptr;
+
+        vhit += qatomic_read(&env_tlb(env)->d[mmu_idx].vtlb_hit_count);
+        miss += qatomic_read(&env_tlb(env)->d[mmu_idx].tlb_miss_count);
+    }
+    *pvhit = vhit;
+    *pmiss = miss;
 }
 
 static void tlb_flush_by_mmuidx_async_work(CPUState *cpu, run_on_cpu_data data)
@@ -543,47 +561,100 @@ static void tlb_flush_page_by_mmuidx_async_0(CPUState *cpu,
 }
 
 /**
- * tlb_flush_page_by_mmuidx_async_1:
+ * tlb_flush_page_batch_work:
  * @cpu: cpu on which to flush
- * @data: encoded addr + idxmap
+ * @data: the CPUTLBFlushBatch of @cpu to process
  *
  * Helper for tlb_flush_page_by_mmuidx and friends, called through
- * async_run_on_cpu.  The idxmap parameter is encoded in the page
- * offset of the target_ptr field.  This limits the set of mmu_idx
- * that can be passed via this method.
+ * async_run_on_cpu or async_safe_run_on_cpu.  Take all of the page
+ * flushes queued so far and perform them.  Requests queued after this
+ * point will be handled by a new work item.
  */
-static void tlb_flush_page_by_mmuidx_async_1(CPUState *cpu,
-                                             run_on_cpu_data data)
+static void tlb_flush_page_batch_work(CPUState *cpu, run_on_cpu_data data)
 {
-    target_ulong addr_and_idxmap = (target_ulong) data.target_ptr;
-    target_ulong addr = addr_and_idxmap & TARGET_PAGE_MASK;
-    uint16_t idxmap = addr_and_idxmap & ~TARGET_PAGE_MASK;
+    CPUArchState *env = cpu->env_ptr;
+    CPUTLBFlushBatch *batch = data.host_ptr;
+    CPUTLBFlushBatch b;
+    int i;
 
-    tlb_flush_page_by_mmuidx_async_0(cpu, addr, idxmap);
-}
+    qemu_spin_lock(&env_tlb(env)->c.lock);
+    b = *batch;
+    batch->queued = false;
+    batch->n = 0;
+    batch->full_idxmap = 0;
+    qemu_spin_unlock(&env_tlb(env)->c.lock);
 
-typedef struct {
-    target_ulong addr;
-    uint16_t idxmap;
-} TLBFlushPageByMMUIdxData;
+    if (b.full_idxmap) {
+        tlb_flush_by_mmuidx_async_work(cpu,
+                                       RUN_ON_CPU_HOST_INT(b.full_idxmap));
+    }
+    for (i = 0; i < b.n; i++) {
+        uint16_t idxmap = b.idxmap[i] & ~b.full_idxmap;
+
+        if (idxmap) {
+            tlb_flush_page_by_mmuidx_async_0(cpu, b.addr[i], idxmap);
+        }
+    }
+}
 
 /**
- * tlb_flush_page_by_mmuidx_async_2:
+ * tlb_flush_page_queue:
  * @cpu: cpu on which to flush
- * @data: allocated addr + idxmap
+ * @addr: page of virtual address to flush
+ * @idxmap: set of mmu_idx to flush
+ * @safe: true to perform the flush in an exclusive context
  *
- * Helper for tlb_flush_page_by_mmuidx and friends, called through
- * async_run_on_cpu.  The addr+idxmap parameters are stored in a
- * TLBFlushPageByMMUIdxData structure that has been allocated
- * specifically for this helper.  Free the structure when done.
+ * Queue the flush of @addr on @cpu.  If a work item for the same kind
+ * of flush is already pending on @cpu, merge the request into it rather
+ * than queuing another one; this turns a burst of page flushes from the
+ * guest into a single work item and, for @safe, a single exclusive
+ * section.
  */
-static void tlb_flush_page_by_mmuidx_async_2(CPUState *cpu,
-                                             run_on_cpu_data data)
+static void tlb_flush_page_queue(CPUState *cpu, target_ulong addr,
+                                 uint16_t idxmap, bool safe)
 {
-    TLBFlushPageByMMUIdxData *d = data.host_ptr;
+    CPUArchState *env = cpu->env_ptr;
+    CPUTLBCommon *c = &env_tlb(env)->c;
+    CPUTLBFlushBatch *batch = safe ? &c->safe_batch : &c->async_batch;
+    bool queue;
+    int i;
 
-    tlb_flush_page_by_mmuidx_async_0(cpu, d->addr, d->idxmap);
-    g_free(d);
+    qemu_spin_lock(&c->lock);
+
+    queue = !batch->queued;
+    if (queue) {
+        batch->queued = true;
+    } else {
+        qatomic_set(&c->merged_flush_count, c->merged_flush_count + 1);
+    }
+
+    for (i = 0; i < batch->n; i++) {
+        if (batch->addr[i] == addr) {
+            batch->idxmap[i] |= idxmap;
+            break;
+        }
+    }
+    if (i == batch->n) {
+        if (i < CPU_TLB_FLUSH_BATCH_SIZE) {
+            batch->addr[i] = addr;
+            batch->idxmap[i] = idxmap;
+            batch->n = i + 1;
+        } else {
+            batch->full_idxmap |= idxmap;
+        }
+    }
+
+    qemu_spin_unlock(&c->lock);
+
+    if (queue) {
+        if (safe) {
+            async_safe_run_on_cpu(cpu, tlb_flush_page_batch_work,
+                                  RUN_ON_CPU_HOST_PTR(batch));
+        } else {
+            async_run_on_cpu(cpu, tlb_flush_page_batch_work,
+                             RUN_ON_CPU_HOST_PTR(batch));
+        }
+    }
 }
 
 void tlb_flush_page_by_mmuidx(CPUState *cpu, target_ulong addr, uint16_t idxmap)
@@ -595,22 +666,8 @@ void tlb_flush_page_by_mmuidx(CPUState *cpu, target_ulong addr, uint16_t idxmap)
 
     if (qemu_cpu_is_self(cpu)) {
         tlb_flush_page_by_mmuidx_async_0(cpu, addr, idxmap);
-    } else if (idxmap < TARGET_PAGE_SIZE) {
-        /*
-         * Most targets have only a few mmu_idx.  In the case where
-         * we can stuff idxmap into the low TARGET_PAGE_BITS, avoid
-         * allocating memory for this operation.
-         */
-        async_run_on_cpu(cpu, tlb_flush_page_by_mmuidx_async_1,
-                         RUN_ON_CPU_TARGET_PTR(addr | idxmap));
     } else {
-        TLBFlushPageByMMUIdxData *d = g_new(TLBFlushPageByMMUIdxData, 1);
-
-        /* Otherwise allocate a structure, freed by the worker.  */
-        d->addr = addr;
-        d->idxmap = idxmap;
-        async_run_on_cpu(cpu, tlb_flush_page_by_mmuidx_async_2,
-                         RUN_ON_CPU_HOST_PTR(d));
+        tlb_flush_page_queue(cpu, addr, idxmap, false);
     }
 }
 
@@ -622,32 +679,16 @@ void tlb_flush_page(CPUState *cpu, target_ulong addr)
 void tlb_flush_page_by_mmuidx_all_cpus(CPUState *src_cpu, target_ulong addr,
                                        uint16_t idxmap)
 {
+    CPUState *dst_cpu;
+
     tlb_debug("addr: "TARGET_FMT_lx" mmu_idx:%"PRIx16"\n", addr, idxmap);
 
     /* This should already be page aligned */
     addr &= TARGET_PAGE_MASK;
 
-    /*
-     * Allocate memory to hold addr+idxmap only when needed.
-     * See tlb_flush_page_by_mmuidx for details.
-     */
-    if (idxmap < TARGET_PAGE_SIZE) {
-        flush_all_helper(src_cpu, tlb_flush_page_by_mmuidx_async_1,
-                         RUN_ON_CPU_TARGET_PTR(addr | idxmap));
-    } else {
-        CPUState *dst_cpu;
-
-        /* Allocate a separate data block for each destination cpu.  */
-        CPU_FOREACH(dst_cpu) {
-            if (dst_cpu != src_cpu) {
-                TLBFlushPageByMMUIdxData *d
-                    = g_new(TLBFlushPageByMMUIdxData, 1);
-
-                d->addr = addr;
-                d->idxmap = idxmap;
-                async_run_on_cpu(dst_cpu, tlb_flush_page_by_mmuidx_async_2,
-                                 RUN_ON_CPU_HOST_PTR(d));
-            }
+    CPU_FOREACH(dst_cpu) {
+        if (dst_cpu != src_cpu) {
+            tlb_flush_page_queue(dst_cpu, addr, idxmap, false);
         }
     }
 
@@ -663,41 +704,20 @@ void tlb_flush_page_by_mmuidx_all_cpus_synced(CPUState *src_cpu,
                                               target_ulong addr,
                                               uint16_t idxmap)
 {
+    CPUState *dst_cpu;
+
     tlb_debug("addr: "TARGET_FMT_lx" mmu_idx:%"PRIx16"\n", addr, idxmap);
 
     /* This should already be page aligned */
     addr &= TARGET_PAGE_MASK;
 
-    /*
-     * Allocate memory to hold addr+idxmap only when needed.
-     * See tlb_flush_page_by_mmuidx for details.
-     */
-    if (idxmap < TARGET_PAGE_SIZE) {
-        flush_all_helper(src_cpu, tlb_flush_page_by_mmuidx_async_1,
-                         RUN_ON_CPU_TARGET_PTR(addr | idxmap));
-        async_safe_run_on_cpu(src_cpu, tlb_flush_page_by_mmuidx_async_1,
-                              RUN_ON_CPU_TARGET_PTR(addr | idxmap));
-    } else {
-        CPUState *dst_cpu;
-        TLBFlushPageByMMUIdxData *d;
-
-        /* Allocate a separate data block for each destination cpu.  */
-        CPU_FOREACH(dst_cpu) {
-            if (dst_cpu != src_cpu) {
-                d = g_new(TLBFlushPageByMMUIdxData, 1);
-                d->addr = addr;
-                d->idxmap = idxmap;
-                async_run_on_cpu(dst_cpu, tlb_flush_page_by_mmuidx_async_2,
-                                 RUN_ON_CPU_HOST_PTR(d));
-            }
+    CPU_FOREACH(dst_cpu) {
+        if (dst_cpu != src_cpu) {
+            tlb_flush_page_queue(dst_cpu, addr, idxmap, false);
         }
-
-        d = g_new(TLBFlushPageByMMUIdxData, 1);
-        d->addr = addr;
-        d->idxmap = idxmap;
-        async_safe_run_on_cpu(src_cpu, tlb_flush_page_by_mmuidx_async_2,
-                              RUN_ON_CPU_HOST_PTR(d));
     }
+
+    tlb_flush_page_queue(src_cpu, addr, idxmap, true);
 }
 
 void tlb_flush_page_all_cpus_synced(CPUState *src, target_ulong addr)
@@ -1461,11 +1481,12 @@ static inline target_ulong tlb_read_ofs(CPUTLBEntry *entry, size_t ofs)
 static bool victim_tlb_hit(CPUArchState *env, size_t mmu_idx, size_t index,
                            size_t elt_ofs, target_ulong page)
 {
+    CPUTLBDesc *desc = &env_tlb(env)->d[mmu_idx];
     size_t vidx;
 
     assert_cpu_is_self(env_cpu(env));
     for (vidx = 0; vidx < CPU_VTLB_SIZE; ++vidx) {
-        CPUTLBEntry *vtlb = &env_tlb(env)->d[mmu_idx].vtable[vidx];
+        CPUTLBEntry *vtlb = &desc->vtable[vidx];
         target_ulong cmp;
 
         /* elt_ofs might correspond to .addr_write, so use qatomic_read */
@@ -1485,13 +1506,16 @@ static bool victim_tlb_hit(CPUArchState *env, size_t mmu_idx, size_t index,
             copy_tlb_helper_locked(vtlb, &tmptlb);
             qemu_spin_unlock(&env_tlb(env)->c.lock);
 
-            CPUTLBEntryFull *f1 = &env_tlb(env)->d[mmu_idx].fulltlb[index];
-            CPUTLBEntryFull *f2 = &env_tlb(env)->d[mmu_idx].vfulltlb[vidx];
+            CPUTLBEntryFull *f1 = &desc->fulltlb[index];
+            CPUTLBEntryFull *f2 = &desc->vfulltlb[vidx];
             CPUTLBEntryFull tmpf;
             tmpf = *f1; *f1 = *f2; *f2 = tmpf;
+
+            qatomic_set(&desc->vtlb_hit_count, desc->vtlb_hit_count + 1);
             return true;
         }
     }
+    qatomic_set(&desc->tlb_miss_count, desc->tlb_miss_count + 1);
     return false;
 }
 
@@ -0,0 +1,167 @@
+/*
+ * Guest program counter sampler
+ *
+ * Periodically asks each running vCPU to record its program counter,
+ * so that hot guest code can be found without instrumenting every
+ * block or instruction.  A sample is taken from queued CPU work, i.e.
+ * at a TB boundary where the CPU state is consistent, so the cost while
+ * enabled is one exit from the execution loop per vCPU per period and
+ * the cost while disabled is nothing.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/main-loop.h"
+#include "qemu/timer.h"
+#include "qapi/error.h"
+#include "qapi/qapi-commands-machine.h"
+#include "qapi/type-helpers.h"
+#include "hw/boards.h"
+#include "hw/core/cpu.h"
+#include "sysemu/tcg.h"
+
+#define SAMPLER_RING_SIZE       4096
+#define SAMPLER_DEFAULT_FREQ    100
+#define SAMPLER_MAX_FREQ        10000
+
+/*
+ * Each vCPU keeps the program counters of its last SAMPLER_RING_SIZE
+ * samples.  Samples are written from queued work and read by the
+ * monitor, both of which run under the BQL.
+ */
+typedef struct SamplerRing {
+    vaddr pc[SAMPLER_RING_SIZE];
+    uint64_t count;
+    bool scheduled;
+} SamplerRing;
+
+static QEMUTimer *sampler_timer;
+static SamplerRing *sampler_rings;
+static unsigned int sampler_nr_rings;
+static int64_t sampler_period_ns;
+
+static void sampler_take_sample(CPUState *cpu, run_on_cpu_data opaque)
+{
+    CPUClass *cc = CPU_GET_CLASS(cpu);
+    SamplerRing *ring;
+
+    /* Only scheduled by sampler_timer_tick() for CPUs that have a ring */
+    assert(cpu->cpu_index < sampler_nr_rings);
+    ring = &sampler_rings[cpu->cpu_index];
+    ring->pc[ring->count++ % SAMPLER_RING_SIZE] = cc->get_pc(cpu);
+    ring->scheduled = false;
+}
+
+static void sampler_timer_tick(void *opaque)
+{
+    CPUState *cpu;
+
+    /* Stop the timer if needed */
+    if (!sampler_period_ns) {
+        return;
+    }
+    CPU_FOREACH(cpu) {
+        SamplerRing *ring;
+
+        /* Rings were sized for max_cpus, ignore any CPU beyond that */
+        if (cpu->cpu_index >= sampler_nr_rings) {
+            continue;
+        }
+        ring = &sampler_rings[cpu->cpu_index];
+
+        /* Don't wake up idle vCPUs just to sample the idle loop */
+        if (cpu->halted || ring->scheduled) {
+            continue;
+        }
+        ring->scheduled = true;
+        async_run_on_cpu(cpu, sampler_take_sample, RUN_ON_CPU_NULL);
+    }
+
+    timer_mod(sampler_timer, qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL_RT) +
+                             sampler_period_ns);
+}
+
+void qmp_x_tcg_sampler(bool enable, bool has_frequency, uint32_t frequency,
+                       Error **errp)
+{
+    bool active = sampler_period_ns != 0;
+
+    if (!tcg_enabled()) {
+        error_setg(errp, "Sampling is only available with accel=tcg");
+        return;
+    }
+
+    if (!enable) {
+        sampler_period_ns = 0;
+        return;
+    }
+
+    if (!has_frequency) {
+        frequency = SAMPLER_DEFAULT_FREQ;
+    } else if (frequency == 0 || frequency > SAMPLER_MAX_FREQ) {
+        error_setg(errp, "frequency must be between 1 and %d",
+                   SAMPLER_MAX_FREQ);
+        return;
+    }
+
+    if (!sampler_rings) {
+        sampler_nr_rings = MACHINE(qdev_get_machine())->smp.max_cpus;
+        sampler_rings = g_new0(SamplerRing, sampler_nr_rings);
+        sampler_timer = timer_new_ns(QEMU_CLOCK_VIRTUAL_RT,
+                                     sampler_timer_tick, NULL);
+    } else if (!active) {
+        /* Start a fresh profile */
+        for (int i = 0; i < sampler_nr_rings; i++) {
+            sampler_rings[i].count = 0;
+        }
+    }
+
+    sampler_period_ns = NANOSECONDS_PER_SECOND / frequency;
+    if (!active) {
+        sampler_timer_tick(NULL);
+    }
+}
+
+static int sampler_cmp_pc(const void *a, const void *b)
+{
+    vaddr pa = *(const vaddr *)a;
+    vaddr pb = *(const vaddr *)b;
+
+    return pa < pb ? -1 : pa > pb;
+}
+
+HumanReadableText *qmp_x_query_tcg_samples(Error **errp)
+{
+    g_autoptr(GString) buf = g_string_new("");
+    g_autofree vaddr *pcs = g_new(vaddr, SAMPLER_RING_SIZE);
+
+    if (!tcg_enabled()) {
+        error_setg(errp, "Sampling is only available with accel=tcg");
+        return NULL;
+    }
+    if (!sampler_rings) {
+        error_setg(errp, "Sampling has not been enabled");
+        return NULL;
+    }
+
+    /* Folded stacks: one "cpu;pc count" line per distinct pc */
+    for (int i = 0; i < sampler_nr_rings; i++) {
+        SamplerRing *ring = &sampler_rings[i];
+        size_t n = MIN(ring->count, SAMPLER_RING_SIZE);
+        size_t j, k;
+
+        memcpy(pcs, ring->pc, n * sizeof(vaddr));
+        qsort(pcs, n, sizeof(vaddr), sampler_cmp_pc);
+
+        for (j = 0; j < n; j = k) {
+            for (k = j + 1; k < n && pcs[k] == pcs[j]; k++) {
+                continue;
+            }
+            g_string_append_printf(buf, "cpu%d;0x%" VADDR_PRIx " %zu\n",
+                                   i, pcs[j], k - j);
+        }
+    }
+
+    return human_readable_text_from_str(buf);
+}
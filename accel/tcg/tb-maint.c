@@ -231,10 +231,14 @@ static void tb_jmp_cache_inval_tb(TranslationBlock *tb)
     CPUState *cpu;
 
     if (TARGET_TB_PCREL) {
-        /* A TB may be at any virtual address */
-        CPU_FOREACH(cpu) {
-            tcg_flush_jmp_cache(cpu);
-        }
+        /*
+         * A TB may be at any virtual address, so we cannot find the
+         * entries that point to it without flushing every vCPU's cache,
+         * which with many vCPUs is far more expensive than the lookups
+         * it saves.  Leave any stale entries in place: CF_INVALID is
+         * already set, so tb_lookup() will never match them, and TBs
+         * are only freed by tb_flush(), which flushes the caches itself.
+         */
     } else {
         uint32_t h = tb_jmp_cache_hash_func(tb_pc(tb));
 
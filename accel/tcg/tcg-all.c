@@ -37,6 +37,7 @@
 #include "hw/boards.h"
 #endif
 #include "internal.h"
+#include "perf.h"
 
 struct TCGState {
     AccelState parent_obj;
@@ -44,6 +45,8 @@ struct TCGState {
     bool mttcg_enabled;
     int splitwx_enabled;
     unsigned long tb_size;
+    bool perfmap_enabled;
+    bool jitdump_enabled;
 };
 typedef struct TCGState TCGState;
 
@@ -122,6 +125,19 @@ static int tcg_init_machine(MachineState *ms)
     tcg_allowed = true;
     mttcg_enabled = s->mttcg_enabled;
 
+    if (s->perfmap_enabled) {
+        perf_enable_perfmap();
+    }
+    if (s->jitdump_enabled) {
+        perf_enable_jitdump();
+    }
+#ifndef CONFIG_USER_ONLY
+    /* linux-user closes the files in preexit_cleanup() */
+    if (s->perfmap_enabled || s->jitdump_enabled) {
+        atexit(perf_exit);
+    }
+#endif
+
     page_init();
     tb_htable_init();
     tcg_init(s->tb_size * MiB, s->splitwx_enabled, max_cpus);
@@ -208,6 +224,32 @@ static void tcg_set_splitwx(Object *obj, bool value, Error **errp)
     s->splitwx_enabled = value;
 }
 
+#ifdef CONFIG_POSIX
+static bool tcg_get_perfmap(Object *obj, Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+    return s->perfmap_enabled;
+}
+
+static void tcg_set_perfmap(Object *obj, bool value, Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+    s->perfmap_enabled = value;
+}
+
+static bool tcg_get_jitdump(Object *obj, Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+    return s->jitdump_enabled;
+}
+
+static void tcg_set_jitdump(Object *obj, bool value, Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+    s->jitdump_enabled = value;
+}
+#endif
+
 static int tcg_gdbstub_supported_sstep_flags(void)
 {
     /*
@@ -245,6 +287,18 @@ static void tcg_accel_class_init(ObjectClass *oc, void *data)
         tcg_get_splitwx, tcg_set_splitwx);
     object_class_property_set_description(oc, "split-wx",
         "Map jit pages into separate RW and RX regions");
+
+#ifdef CONFIG_POSIX
+    object_class_property_add_bool(oc, "perfmap",
+        tcg_get_perfmap, tcg_set_perfmap);
+    object_class_property_set_description(oc, "perfmap",
+        "Write /tmp/perf-<pid>.map describing translated code");
+
+    object_class_property_add_bool(oc, "jitdump",
+        tcg_get_jitdump, tcg_set_jitdump);
+    object_class_property_set_description(oc, "jitdump",
+        "Write jit-<pid>.dump for use with 'perf inject --jit'");
+#endif
 }
 
 static const TypeInfo tcg_accel_type = {
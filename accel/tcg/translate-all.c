@@ -62,6 +62,7 @@
 #include "tb-hash.h"
 #include "tb-context.h"
 #include "internal.h"
+#include "perf.h"
 
 /* make various TB consistency checks */
 
@@ -884,6 +885,12 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
     }
     tb->tc.size = gen_code_size;
 
+    /*
+     * Report the code under the virtual pc it was generated for; with
+     * TARGET_TB_PCREL this is just the first of its possible addresses.
+     */
+    perf_report_code(pc, tb, tcg_splitwx_to_rx(gen_code_buf));
+
 #ifdef CONFIG_PROFILER
     qatomic_set(&prof->code_time, prof->code_time + profile_getclock() - ti);
     qatomic_set(&prof->code_in_len, prof->code_in_len + tb->size);
@@ -1177,7 +1184,7 @@ void dump_exec_info(GString *buf)
 {
     struct tb_tree_stats tst = {};
     struct qht_stats hst;
-    size_t nb_tbs, flush_full, flush_part, flush_elide;
+    size_t nb_tbs, flush_full, flush_part, flush_elide, flush_merged;
 
     tcg_tb_foreach(tb_tree_stats_iter, &tst);
     nb_tbs = tst.nb_tbs;
@@ -1219,10 +1226,22 @@ void dump_exec_info(GString *buf)
     g_string_append_printf(buf, "TB invalidate count %u\n",
                            qatomic_read(&tb_ctx.tb_phys_invalidate_count));
 
-    tlb_flush_counts(&flush_full, &flush_part, &flush_elide);
+    tlb_flush_counts(&flush_full, &flush_part, &flush_elide, &flush_merged);
     g_string_append_printf(buf, "TLB full flushes    %zu\n", flush_full);
     g_string_append_printf(buf, "TLB partial flushes %zu\n", flush_part);
     g_string_append_printf(buf, "TLB elided flushes  %zu\n", flush_elide);
+    g_string_append_printf(buf, "TLB merged flushes  %zu\n", flush_merged);
+    for (int i = 0; i < NB_MMU_MODES; i++) {
+        size_t vhit, miss;
+
+        tlb_miss_counts(i, &vhit, &miss);
+        if (vhit || miss) {
+            g_string_append_printf(buf, "TLB mmu_idx %d slow path %zu "
+                                   "(victim hits %zu%%, fills %zu)\n",
+                                   i, vhit + miss,
+                                   (vhit * 100) / (vhit + miss), miss);
+        }
+    }
     tcg_dump_info(buf);
 }
 
@@ -1347,6 +1366,19 @@ void page_dump(FILE *f)
     walk_memory_regions(f, dump_region);
 }
 
+/*
+ * Return the number of pages, starting with page @index and covering
+ * at most @len bytes, whose PageDesc live in the same leaf of l1_map.
+ * Those entries are contiguous, so a range can be walked with one
+ * page_find() per leaf instead of one radix tree walk per page.
+ */
+static target_ulong page_leaf_run(tb_page_addr_t index, target_ulong len)
+{
+    target_ulong n = V_L2_SIZE - (index & (V_L2_SIZE - 1));
+
+    return MIN(n, len >> TARGET_PAGE_BITS);
+}
+
 int page_get_flags(target_ulong address)
 {
     PageDesc *p;
@@ -1355,7 +1387,8 @@ int page_get_flags(target_ulong address)
     if (!p) {
         return 0;
     }
-    return p->flags;
+    /* Lockless: pairs with the qatomic_set in page_set_flags et al. */
+    return qatomic_read(&p->flags);
 }
 
 /*
@@ -1396,23 +1429,28 @@ void page_set_flags(target_ulong start, target_ulong end, int flags)
     }
     flags &= ~PAGE_RESET;
 
-    for (addr = start, len = end - start;
-         len != 0;
-         len -= TARGET_PAGE_SIZE, addr += TARGET_PAGE_SIZE) {
-        PageDesc *p = page_find_alloc(addr >> TARGET_PAGE_BITS, true);
+    for (addr = start, len = end - start; len != 0; ) {
+        tb_page_addr_t index = addr >> TARGET_PAGE_BITS;
+        PageDesc *p = page_find_alloc(index, true);
+        target_ulong n = page_leaf_run(index, len);
 
-        /*
-         * If the page was executable, but is reset, or is no longer
-         * executable, or has become writable, then invalidate any code.
-         */
-        if ((p->flags & PAGE_EXEC)
-            && (reset ||
-                !(flags & PAGE_EXEC) ||
-                (flags & ~p->flags & PAGE_WRITE))) {
-            inval_tb = true;
+        len -= n << TARGET_PAGE_BITS;
+        addr += n << TARGET_PAGE_BITS;
+        for (; n != 0; n--, p++) {
+            /*
+             * If the page was executable, but is reset, or is no longer
+             * executable, or has become writable, then invalidate any code.
+             */
+            if ((p->flags & PAGE_EXEC)
+                && (reset ||
+                    !(flags & PAGE_EXEC) ||
+                    (flags & ~p->flags & PAGE_WRITE))) {
+                inval_tb = true;
+            }
+            /* Using mprotect on a page does not change sticky bits. */
+            qatomic_set(&p->flags,
+                        (reset ? 0 : p->flags & PAGE_STICKY) | flags);
         }
-        /* Using mprotect on a page does not change sticky bits. */
-        p->flags = (reset ? 0 : p->flags & PAGE_STICKY) | flags;
     }
 
     if (inval_tb) {
@@ -1445,30 +1483,34 @@ int page_check_range(target_ulong start, target_ulong len, int flags)
     end = TARGET_PAGE_ALIGN(start + len);
     start = start & TARGET_PAGE_MASK;
 
-    for (addr = start, len = end - start;
-         len != 0;
-         len -= TARGET_PAGE_SIZE, addr += TARGET_PAGE_SIZE) {
-        p = page_find(addr >> TARGET_PAGE_BITS);
+    for (addr = start, len = end - start; len != 0; ) {
+        tb_page_addr_t index = addr >> TARGET_PAGE_BITS;
+        target_ulong n = page_leaf_run(index, len);
+
+        p = page_find(index);
         if (!p) {
             return -1;
         }
-        if (!(p->flags & PAGE_VALID)) {
-            return -1;
-        }
+        for (; n != 0; n--, p++, len -= TARGET_PAGE_SIZE,
+                 addr += TARGET_PAGE_SIZE) {
+            if (!(p->flags & PAGE_VALID)) {
+                return -1;
+            }
 
-        if ((flags & PAGE_READ) && !(p->flags & PAGE_READ)) {
-            return -1;
-        }
-        if (flags & PAGE_WRITE) {
-            if (!(p->flags & PAGE_WRITE_ORG)) {
+            if ((flags & PAGE_READ) && !(p->flags & PAGE_READ)) {
                 return -1;
             }
-            /* unprotect the page if it was put read-only because it
-               contains translated code */
-            if (!(p->flags & PAGE_WRITE)) {
-                if (!page_unprotect(addr, 0)) {
+            if (flags & PAGE_WRITE) {
+                if (!(p->flags & PAGE_WRITE_ORG)) {
                     return -1;
                 }
+                /* unprotect the page if it was put read-only because it
+                   contains translated code */
+                if (!(p->flags & PAGE_WRITE)) {
+                    if (!page_unprotect(addr, 0)) {
+                        return -1;
+                    }
+                }
             }
         }
     }
@@ -1497,7 +1539,7 @@ void page_protect(tb_page_addr_t page_addr)
                 continue;
             }
             prot |= p->flags;
-            p->flags &= ~PAGE_WRITE;
+            qatomic_set(&p->flags, p->flags & ~PAGE_WRITE);
         }
         mprotect(g2h_untagged(page_addr), qemu_host_page_size,
                  (prot & PAGE_BITS) & ~PAGE_WRITE);
@@ -1550,7 +1592,7 @@ int page_unprotect(target_ulong address, uintptr_t pc)
             prot = 0;
             for (addr = host_start; addr < host_end; addr += TARGET_PAGE_SIZE) {
                 p = page_find(addr >> TARGET_PAGE_BITS);
-                p->flags |= PAGE_WRITE;
+                qatomic_set(&p->flags, p->flags | PAGE_WRITE);
                 prot |= p->flags;
 
                 /* and since the content will be modified, we must invalidate
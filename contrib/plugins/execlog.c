@@ -23,6 +23,7 @@ static GMutex expand_array_lock;
 
 static GPtrArray *imatches;
 static GArray *amatches;
+static GArray *rmatches;
 
 /*
  * Expand last_exec array.
@@ -95,6 +96,22 @@ static void vcpu_insn_exec(unsigned int cpu_index, void *udata)
     /* vcpu_mem will add memory access information to last_exec */
     g_string_printf(s, "%u, ", cpu_index);
     g_string_append(s, (char *)udata);
+
+    /* Registers as they are before the instruction executes */
+    if (rmatches) {
+        uint8_t buf[64];
+        int j, k;
+
+        for (j = 0; j < rmatches->len; j++) {
+            unsigned int reg = g_array_index(rmatches, unsigned int, j);
+            int size = qemu_plugin_read_register(reg, buf, sizeof(buf));
+
+            g_string_append_printf(s, ", reg%u=", reg);
+            for (k = 0; k < MIN(size, (int) sizeof(buf)); k++) {
+                g_string_append_printf(s, "%02x", buf[k]);
+            }
+        }
+    }
 }
 
 /**
@@ -164,7 +181,10 @@ static void vcpu_tb_trans(qemu_plugin_id_t id, struct qemu_plugin_tb *tb)
 
             /* Register callback on instruction */
             qemu_plugin_register_vcpu_insn_exec_cb(insn, vcpu_insn_exec,
-                                                   QEMU_PLUGIN_CB_NO_REGS, output);
+                                                   rmatches ?
+                                                   QEMU_PLUGIN_CB_R_REGS :
+                                                   QEMU_PLUGIN_CB_NO_REGS,
+                                                   output);
 
             /* reset skip */
             skip = (imatches || amatches);
@@ -208,6 +228,16 @@ static void parse_vaddr_match(char *match)
     g_array_append_val(amatches, v);
 }
 
+static void parse_reg_match(char *match)
+{
+    unsigned int r = g_ascii_strtoull(match, NULL, 10);
+
+    if (!rmatches) {
+        rmatches = g_array_new(false, true, sizeof(unsigned int));
+    }
+    g_array_append_val(rmatches, r);
+}
+
 /**
  * Install the plugin
  */
@@ -232,6 +262,8 @@ QEMU_PLUGIN_EXPORT int qemu_plugin_install(qemu_plugin_id_t id,
             parse_insn_match(tokens[1]);
         } else if (g_strcmp0(tokens[0], "afilter") == 0) {
             parse_vaddr_match(tokens[1]);
+        } else if (g_strcmp0(tokens[0], "reg") == 0) {
+            parse_reg_match(tokens[1]);
         } else {
             fprintf(stderr, "option parsing failed: %s\n", opt);
             return -1;
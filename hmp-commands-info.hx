@@ -283,6 +283,21 @@ SRST
     Show dynamic compiler opcode counters
 ERST
 
+#if defined(CONFIG_TCG)
+    {
+        .name       = "tcg-samples",
+        .args_type  = "",
+        .params     = "",
+        .help       = "show guest program counter samples",
+    },
+#endif
+
+SRST
+  ``info tcg-samples``
+    Show the guest program counter samples taken since sampling was
+    enabled with the QMP command ``x-tcg-sampler``.
+ERST
+
     {
         .name       = "sync-profile",
         .args_type  = "mean:-m,no_coalesce:-n,max:i?",
@@ -195,6 +195,13 @@ typedef struct CPUTLBDesc {
     /* maximum number of entries observed in the window */
     size_t window_max_entries;
     size_t n_used_entries;
+    /*
+     * Statistics for accesses that missed the fast path tlb: those
+     * found in the victim table, and those that needed a tlb_fill.
+     * Written by the owning cpu only, read atomically by the monitor.
+     */
+    size_t vtlb_hit_count;
+    size_t tlb_miss_count;
     /* The next index to use in the tlb victim table.  */
     size_t vindex;
     /* The tlb victim table, in two parts.  */
@@ -214,6 +221,26 @@ typedef struct CPUTLBDescFast {
     CPUTLBEntry *table;
 } CPUTLBDescFast QEMU_ALIGNED(2 * sizeof(void *));
 
+/* The number of distinct pages that can be queued in a CPUTLBFlushBatch. */
+#define CPU_TLB_FLUSH_BATCH_SIZE 16
+
+/*
+ * Page flushes queued for a cpu, to be processed by a single work item.
+ * Requests that arrive while the work item is still pending are merged
+ * into it; once it is full, further requests are widened to a flush of
+ * the whole of each affected mmu_idx.
+ */
+typedef struct CPUTLBFlushBatch {
+    /* True while a work item for this batch is queued but not started. */
+    bool queued;
+    /* The number of valid entries in addr[] and idxmap[]. */
+    uint16_t n;
+    /* The mmu_idx to flush entirely, after the batch overflowed. */
+    uint16_t full_idxmap;
+    uint16_t idxmap[CPU_TLB_FLUSH_BATCH_SIZE];
+    target_ulong addr[CPU_TLB_FLUSH_BATCH_SIZE];
+} CPUTLBFlushBatch;
+
 /*
  * Data elements that are shared between all MMU modes.
  */
@@ -234,6 +261,13 @@ typedef struct CPUTLBCommon {
     size_t full_flush_count;
     size_t part_flush_count;
     size_t elide_flush_count;
+    size_t merged_flush_count;
+    /*
+     * Page flushes queued by other cpus, and by synced flushes from this
+     * cpu which must run in an exclusive context.  Protected by lock.
+     */
+    CPUTLBFlushBatch async_batch;
+    CPUTLBFlushBatch safe_batch;
 } CPUTLBCommon;
 
 /*
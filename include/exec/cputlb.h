@@ -26,6 +26,8 @@
 /* cputlb.c */
 void tlb_protect_code(ram_addr_t ram_addr);
 void tlb_unprotect_code(ram_addr_t ram_addr);
-void tlb_flush_counts(size_t *full, size_t *part, size_t *elide);
+void tlb_flush_counts(size_t *full, size_t *part, size_t *elide,
+                      size_t *merged);
+void tlb_miss_counts(int mmu_idx, size_t *vhit, size_t *miss);
 #endif
 #endif
@@ -74,6 +74,16 @@ struct RAMBlock {
      * could not have been valid on the source.
      */
     ram_addr_t postcopy_length;
+
+    /*
+     * With the mapped-ram capability, the pages of the block are written
+     * at pages_offset in the migration file, and file_bmap records which
+     * of them hold data.  file_bmap is saved at bitmap_offset once the
+     * migration completes.
+     */
+    unsigned long *file_bmap;
+    off_t bitmap_offset;
+    off_t pages_offset;
 };
 #endif
 #endif
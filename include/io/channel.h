@@ -41,6 +41,7 @@ enum QIOChannelFeature {
     QIO_CHANNEL_FEATURE_SHUTDOWN,
     QIO_CHANNEL_FEATURE_LISTEN,
     QIO_CHANNEL_FEATURE_WRITE_ZERO_COPY,
+    QIO_CHANNEL_FEATURE_SEEKABLE,
 };
 
 
@@ -135,6 +136,16 @@ struct QIOChannelClass {
                      off_t offset,
                      int whence,
                      Error **errp);
+    ssize_t (*io_pwrite)(QIOChannel *ioc,
+                         const char *buf,
+                         size_t buflen,
+                         off_t offset,
+                         Error **errp);
+    ssize_t (*io_pread)(QIOChannel *ioc,
+                        char *buf,
+                        size_t buflen,
+                        off_t offset,
+                        Error **errp);
     void (*io_set_aio_fd_handler)(QIOChannel *ioc,
                                   AioContext *ctx,
                                   IOHandler *io_read,
@@ -606,6 +617,47 @@ off_t qio_channel_io_seek(QIOChannel *ioc,
                           int whence,
                           Error **errp);
 
+/**
+ * qio_channel_pwrite:
+ * @ioc: the channel object
+ * @buf: the memory region to write data from
+ * @buflen: the number of bytes in @buf
+ * @offset: the position in the channel to write at
+ * @errp: pointer to a NULL-initialized error object
+ *
+ * Writes @buflen bytes from @buf at position @offset of the
+ * channel, without changing the current I/O position.  The
+ * channel must have the QIO_CHANNEL_FEATURE_SEEKABLE feature.
+ * As with write(2), fewer bytes than requested may be written.
+ *
+ * Returns: the number of bytes written, or -1 on error
+ */
+ssize_t qio_channel_pwrite(QIOChannel *ioc,
+                           const char *buf,
+                           size_t buflen,
+                           off_t offset,
+                           Error **errp);
+
+/**
+ * qio_channel_pread:
+ * @ioc: the channel object
+ * @buf: the memory region to read data into
+ * @buflen: the number of bytes to read into @buf
+ * @offset: the position in the channel to read from
+ * @errp: pointer to a NULL-initialized error object
+ *
+ * Reads up to @buflen bytes into @buf from position @offset of
+ * the channel, without changing the current I/O position.  The
+ * channel must have the QIO_CHANNEL_FEATURE_SEEKABLE feature.
+ *
+ * Returns: the number of bytes read, 0 at end of file, or -1 on error
+ */
+ssize_t qio_channel_pread(QIOChannel *ioc,
+                          char *buf,
+                          size_t buflen,
+                          off_t offset,
+                          Error **errp);
+
 
 /**
  * qio_channel_create_watch:
@@ -51,7 +51,7 @@ typedef uint64_t qemu_plugin_id_t;
 
 extern QEMU_PLUGIN_EXPORT int qemu_plugin_version;
 
-#define QEMU_PLUGIN_VERSION 1
+#define QEMU_PLUGIN_VERSION 2
 
 /**
  * struct qemu_info_t - system information for plugins
@@ -218,8 +218,10 @@ struct qemu_plugin_insn;
  * @QEMU_PLUGIN_CB_R_REGS: callback reads the CPU's regs
  * @QEMU_PLUGIN_CB_RW_REGS: callback reads and writes the CPU's regs
  *
- * Note: currently unused, plugins cannot read or change system
- * register state.
+ * Callbacks for tb and instruction execution registered with
+ * QEMU_PLUGIN_CB_R_REGS may use qemu_plugin_read_register(). Plugins
+ * cannot change register state, so QEMU_PLUGIN_CB_RW_REGS is treated
+ * the same as QEMU_PLUGIN_CB_R_REGS.
  */
 enum qemu_plugin_cb_flags {
     QEMU_PLUGIN_CB_NO_REGS,
@@ -300,6 +302,27 @@ void qemu_plugin_register_vcpu_tb_exec_inline(struct qemu_plugin_tb *tb,
                                               enum qemu_plugin_op op,
                                               void *ptr, uint64_t imm);
 
+/**
+ * qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu() - per-vCPU inline op
+ * @tb: the opaque qemu_plugin_tb handle for the translation
+ * @op: the type of qemu_plugin_op (e.g. ADD_U64)
+ * @ptr: base of an array holding one target location per vCPU
+ * @stride: distance in bytes between the locations of consecutive vCPUs
+ * @imm: the op data (e.g. 1)
+ *
+ * Like qemu_plugin_register_vcpu_tb_exec_inline(), but the op is applied
+ * to @ptr + vcpu_index * @stride.  Each vCPU thus updates its own
+ * counter, which gives exact results under MTTCG without the cost of a
+ * callback; the plugin can sum the counters when it needs a total.
+ *
+ * @ptr must have room for qemu_plugin_n_max_vcpus() locations.  In
+ * user-mode, where the number of vCPUs is not bounded, use the global
+ * inline ops instead.
+ */
+void qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu(
+    struct qemu_plugin_tb *tb, enum qemu_plugin_op op,
+    void *ptr, size_t stride, uint64_t imm);
+
 /**
  * qemu_plugin_register_vcpu_insn_exec_cb() - register insn execution cb
  * @insn: the opaque qemu_plugin_insn handle for an instruction
@@ -328,6 +351,21 @@ void qemu_plugin_register_vcpu_insn_exec_inline(struct qemu_plugin_insn *insn,
                                                 enum qemu_plugin_op op,
                                                 void *ptr, uint64_t imm);
 
+/**
+ * qemu_plugin_register_vcpu_insn_exec_inline_per_vcpu() - per-vCPU inline op
+ * @insn: the opaque qemu_plugin_insn handle for an instruction
+ * @op: the type of qemu_plugin_op (e.g. ADD_U64)
+ * @ptr: base of an array holding one target location per vCPU
+ * @stride: distance in bytes between the locations of consecutive vCPUs
+ * @imm: the op data (e.g. 1)
+ *
+ * Per-vCPU variant of qemu_plugin_register_vcpu_insn_exec_inline(); see
+ * qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu() for the layout.
+ */
+void qemu_plugin_register_vcpu_insn_exec_inline_per_vcpu(
+    struct qemu_plugin_insn *insn, enum qemu_plugin_op op,
+    void *ptr, size_t stride, uint64_t imm);
+
 /**
  * qemu_plugin_tb_n_insns() - query helper for number of insns in TB
  * @tb: opaque handle to TB passed to callback
@@ -497,6 +535,22 @@ void qemu_plugin_register_vcpu_mem_inline(struct qemu_plugin_insn *insn,
                                           enum qemu_plugin_op op, void *ptr,
                                           uint64_t imm);
 
+/**
+ * qemu_plugin_register_vcpu_mem_inline_per_vcpu() - per-vCPU inline op
+ * @insn: the opaque qemu_plugin_insn handle for an instruction
+ * @rw: monitor reads, writes or both
+ * @op: the type of qemu_plugin_op (e.g. ADD_U64)
+ * @ptr: base of an array holding one target location per vCPU
+ * @stride: distance in bytes between the locations of consecutive vCPUs
+ * @imm: the op data (e.g. 1)
+ *
+ * Per-vCPU variant of qemu_plugin_register_vcpu_mem_inline(); see
+ * qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu() for the layout.
+ */
+void qemu_plugin_register_vcpu_mem_inline_per_vcpu(
+    struct qemu_plugin_insn *insn, enum qemu_plugin_mem_rw rw,
+    enum qemu_plugin_op op, void *ptr, size_t stride, uint64_t imm);
+
 
 
 typedef void
@@ -572,6 +626,32 @@ int qemu_plugin_n_vcpus(void);
 /* returns -1 in user-mode */
 int qemu_plugin_n_max_vcpus(void);
 
+/**
+ * qemu_plugin_read_register() - read a register of the current vCPU
+ * @reg: register number, as used by gdb
+ * @buf: buffer to store the value in
+ * @len: size of @buf in bytes
+ *
+ * Registers are numbered as in the gdb remote protocol: the core
+ * registers of the target's gdb-xml description come first, followed
+ * by those of any additional feature. The value is stored in target
+ * byte order; if @len is too small it is truncated.
+ *
+ * This may only be called from a tb or instruction execution callback
+ * that was registered with QEMU_PLUGIN_CB_R_REGS, as otherwise the
+ * value in the CPU state may be stale. Callbacks registered with
+ * QEMU_PLUGIN_CB_NO_REGS are not slowed down by this.
+ *
+ * Most registers hold their value from before the instruction executes.
+ * Translators do not synchronise everything per instruction, though:
+ * the program counter and lazily computed condition flags (e.g. x86
+ * EFLAGS or arm NZCV) may only be up to date at the start of the block.
+ *
+ * Returns the size of the register in bytes, or 0 if @reg does not
+ * exist.
+ */
+int qemu_plugin_read_register(unsigned int reg, uint8_t *buf, size_t len);
+
 /**
  * qemu_plugin_outs() - output string via QEMU's logging system
  * @string: a string
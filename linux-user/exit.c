@@ -18,6 +18,7 @@
  */
 #include "qemu/osdep.h"
 #include "exec/gdbstub.h"
+#include "accel/tcg/perf.h"
 #include "qemu.h"
 #include "user-internals.h"
 #ifdef CONFIG_GPROF
@@ -38,4 +39,5 @@ void preexit_cleanup(CPUArchState *env, int code)
 #endif
         gdb_exit(code);
         qemu_plugin_user_exit();
+        perf_exit();
 }
@@ -30,15 +30,26 @@ extern TargetFdTrans **target_fd_trans;
 extern QemuMutex target_fd_trans_lock;
 
 extern unsigned int target_fd_max;
+extern unsigned int target_fd_trans_count;
 
 static inline void fd_trans_init(void)
 {
     qemu_mutex_init(&target_fd_trans_lock);
 }
 
+/*
+ * Most processes never open a file descriptor that needs translation.
+ * Let the lookups on the read/write/send/recv paths skip the lock then,
+ * so that threads doing I/O do not serialize on target_fd_trans_lock.
+ */
+static inline bool fd_trans_none(void)
+{
+    return qatomic_read(&target_fd_trans_count) == 0;
+}
+
 static inline TargetFdDataFunc fd_trans_target_to_host_data(int fd)
 {
-    if (fd < 0) {
+    if (fd < 0 || fd_trans_none()) {
         return NULL;
     }
 
@@ -51,7 +62,7 @@ static inline TargetFdDataFunc fd_trans_target_to_host_data(int fd)
 
 static inline TargetFdDataFunc fd_trans_host_to_target_data(int fd)
 {
-    if (fd < 0) {
+    if (fd < 0 || fd_trans_none()) {
         return NULL;
     }
 
@@ -64,7 +75,7 @@ static inline TargetFdDataFunc fd_trans_host_to_target_data(int fd)
 
 static inline TargetFdAddrFunc fd_trans_target_to_host_addr(int fd)
 {
-    if (fd < 0) {
+    if (fd < 0 || fd_trans_none()) {
         return NULL;
     }
 
@@ -88,6 +99,9 @@ static inline void internal_fd_trans_register_unsafe(int fd,
         memset((void *)(target_fd_trans + oldmax), 0,
                (target_fd_max - oldmax) * sizeof(TargetFdTrans *));
     }
+    if (!target_fd_trans[fd]) {
+        qatomic_set(&target_fd_trans_count, target_fd_trans_count + 1);
+    }
     target_fd_trans[fd] = trans;
 }
 
@@ -99,8 +113,9 @@ static inline void fd_trans_register(int fd, TargetFdTrans *trans)
 
 static inline void internal_fd_trans_unregister_unsafe(int fd)
 {
-    if (fd >= 0 && fd < target_fd_max) {
+    if (fd >= 0 && fd < target_fd_max && target_fd_trans[fd]) {
         target_fd_trans[fd] = NULL;
+        qatomic_set(&target_fd_trans_count, target_fd_trans_count - 1);
     }
 }
 
@@ -912,15 +912,21 @@ abi_long target_madvise(abi_ulong start, abi_ulong len_in, int advice)
      * known to have the same semantics in the host and the guest. In this case
      * passthrough is safe, so do it.
      */
-    mmap_lock();
-    if (advice == TARGET_MADV_DONTNEED &&
-        can_passthrough_madv_dontneed(start, end)) {
-        ret = get_errno(madvise(g2h_untagged(start), len, MADV_DONTNEED));
-        if (ret == 0) {
-            page_reset_target_data(start, start + len);
+    if (advice == TARGET_MADV_DONTNEED) {
+        /*
+         * Only take mmap_lock when we may pass the advice through: it
+         * keeps the page flags stable while we act on them.  Runtimes
+         * that issue many other hints must not serialize on it.
+         */
+        mmap_lock();
+        if (can_passthrough_madv_dontneed(start, end)) {
+            ret = get_errno(madvise(g2h_untagged(start), len, MADV_DONTNEED));
+            if (ret == 0) {
+                page_reset_target_data(start, start + len);
+            }
         }
+        mmap_unlock();
     }
-    mmap_unlock();
 
     return ret;
 }
@@ -62,6 +62,15 @@ typedef struct {
     unsigned int target_pages;
     /* Whether this page contains all zeros */
     bool all_zero;
+    /*
+     * Run of contiguous small pages received on the precopy channel and
+     * not placed yet; they are installed with a single UFFDIO_COPY.  The
+     * buffer is mmap()ed (POSTCOPY_BATCH_SIZE bytes) for that channel only.
+     */
+    void *batch_buf;
+    RAMBlock *batch_block;
+    void *batch_host;
+    size_t batch_len;
 } PostcopyTmpPage;
 
 /* State for the incoming migration */
@@ -410,11 +419,14 @@ bool migrate_validate_uuid(void);
 
 bool migrate_auto_converge(void);
 bool migrate_use_multifd(void);
+bool migrate_multifd_zero_page(void);
+bool migrate_mapped_ram(void);
 bool migrate_pause_before_switchover(void);
 int migrate_multifd_channels(void);
 MultiFDCompression migrate_multifd_compression(void);
 int migrate_multifd_zlib_level(void);
 int migrate_multifd_zstd_level(void);
+int migrate_multifd_lz4_level(void);
 
 #ifdef CONFIG_LINUX
 bool migrate_use_zero_copy_send(void);
@@ -475,6 +487,7 @@ bool migration_rate_limit(void);
 void migration_cancel(const Error *error);
 
 void populate_vfio_info(MigrationInfo *info);
+void populate_device_state_info(MigrationInfo *info);
 void postcopy_temp_page_reset(PostcopyTmpPage *tmp_page);
 
 bool migrate_multi_channels_is_allowed(void);
@@ -0,0 +1,276 @@
+/*
+ * Multifd lz4 compression implementation
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include <lz4.h>
+#include <lz4hc.h>
+#include "qemu/bswap.h"
+#include "exec/ramblock.h"
+#include "exec/target_page.h"
+#include "qapi/error.h"
+#include "migration.h"
+#include "trace.h"
+#include "multifd.h"
+
+/*
+ * Unlike zlib and zstd, lz4 is used in block mode: every page is
+ * compressed on its own and preceded by its compressed length as a
+ * big endian 32 bit value.  Pages that do not shrink are sent as they
+ * are, with a length equal to the page size, so that the receiving
+ * side can copy them without going through the decompressor.
+ */
+#define LZ4_HDR_SIZE sizeof(uint32_t)
+
+struct lz4_data {
+    /* compression state, either LZ4_stream_t or LZ4_streamHC_t */
+    void *state;
+    /* compression level, 0 selects the fast compressor */
+    int level;
+    /* compressed buffer */
+    uint8_t *zbuff;
+    /* size of compressed buffer */
+    uint32_t zbuff_len;
+};
+
+/* Multifd lz4 compression */
+
+/**
+ * lz4_send_setup: setup send side
+ *
+ * Setup each channel with lz4 compression.
+ *
+ * Returns 0 for success or -1 for error
+ *
+ * @p: Params for the channel that we are using
+ * @errp: pointer to an error
+ */
+static int lz4_send_setup(MultiFDSendParams *p, Error **errp)
+{
+    struct lz4_data *z = g_new0(struct lz4_data, 1);
+    uint32_t page_count = MULTIFD_PACKET_SIZE / qemu_target_page_size();
+
+    z->level = migrate_multifd_lz4_level();
+    if (z->level) {
+        z->state = g_try_malloc(LZ4_sizeofStateHC());
+    } else {
+        z->state = g_try_malloc(LZ4_sizeofState());
+    }
+    if (!z->state) {
+        g_free(z);
+        error_setg(errp, "multifd %u: out of memory for lz4 state", p->id);
+        return -1;
+    }
+
+    /* This is the maximum size of the compressed buffer */
+    z->zbuff_len = page_count * (LZ4_HDR_SIZE + qemu_target_page_size());
+    z->zbuff = g_try_malloc(z->zbuff_len);
+    if (!z->zbuff) {
+        g_free(z->state);
+        g_free(z);
+        error_setg(errp, "multifd %u: out of memory for zbuff", p->id);
+        return -1;
+    }
+    p->data = z;
+    return 0;
+}
+
+/**
+ * lz4_send_cleanup: cleanup send side
+ *
+ * Close the channel and return memory.
+ *
+ * @p: Params for the channel that we are using
+ * @errp: pointer to an error
+ */
+static void lz4_send_cleanup(MultiFDSendParams *p, Error **errp)
+{
+    struct lz4_data *z = p->data;
+
+    g_free(z->state);
+    z->state = NULL;
+    g_free(z->zbuff);
+    z->zbuff = NULL;
+    g_free(p->data);
+    p->data = NULL;
+}
+
+/**
+ * lz4_send_prepare: prepare date to be able to send
+ *
+ * Create a compressed buffer with all the pages that we are going to
+ * send.
+ *
+ * Returns 0 for success or -1 for error
+ *
+ * @p: Params for the channel that we are using
+ * @errp: pointer to an error
+ */
+static int lz4_send_prepare(MultiFDSendParams *p, Error **errp)
+{
+    struct lz4_data *z = p->data;
+    size_t page_size = qemu_target_page_size();
+    uint32_t pos = 0;
+    uint32_t i;
+
+    for (i = 0; i < p->normal_num; i++) {
+        const char *src = (const char *)p->pages->block->host + p->normal[i];
+        char *dst = (char *)z->zbuff + pos + LZ4_HDR_SIZE;
+        int ret;
+
+        /* Anything that does not fit below page_size is sent raw */
+        if (z->level) {
+            ret = LZ4_compress_HC_extStateHC(z->state, src, dst, page_size,
+                                             page_size - 1, z->level);
+        } else {
+            ret = LZ4_compress_fast_extState(z->state, src, dst, page_size,
+                                             page_size - 1, 1);
+        }
+        if (ret <= 0) {
+            memcpy(dst, src, page_size);
+            ret = page_size;
+        }
+        stl_be_p(z->zbuff + pos, ret);
+        pos += LZ4_HDR_SIZE + ret;
+    }
+    p->iov[p->iovs_num].iov_base = z->zbuff;
+    p->iov[p->iovs_num].iov_len = pos;
+    p->iovs_num++;
+    p->next_packet_size = pos;
+    p->flags |= MULTIFD_FLAG_LZ4;
+
+    return 0;
+}
+
+/**
+ * lz4_recv_setup: setup receive side
+ *
+ * Create the compressed buffer.
+ *
+ * Returns 0 for success or -1 for error
+ *
+ * @p: Params for the channel that we are using
+ * @errp: pointer to an error
+ */
+static int lz4_recv_setup(MultiFDRecvParams *p, Error **errp)
+{
+    struct lz4_data *z = g_new0(struct lz4_data, 1);
+    uint32_t page_count = MULTIFD_PACKET_SIZE / qemu_target_page_size();
+
+    z->zbuff_len = page_count * (LZ4_HDR_SIZE + qemu_target_page_size());
+    z->zbuff = g_try_malloc(z->zbuff_len);
+    if (!z->zbuff) {
+        g_free(z);
+        error_setg(errp, "multifd %u: out of memory for zbuff", p->id);
+        return -1;
+    }
+    p->data = z;
+    return 0;
+}
+
+/**
+ * lz4_recv_cleanup: cleanup receive side
+ *
+ * Return the compressed buffer.
+ *
+ * @p: Params for the channel that we are using
+ */
+static void lz4_recv_cleanup(MultiFDRecvParams *p)
+{
+    struct lz4_data *z = p->data;
+
+    g_free(z->zbuff);
+    z->zbuff = NULL;
+    g_free(p->data);
+    p->data = NULL;
+}
+
+/**
+ * lz4_recv_pages: read the data from the channel into actual pages
+ *
+ * Read the compressed buffer, and uncompress it into the actual
+ * pages.
+ *
+ * Returns 0 for success or -1 for error
+ *
+ * @p: Params for the channel that we are using
+ * @errp: pointer to an error
+ */
+static int lz4_recv_pages(MultiFDRecvParams *p, Error **errp)
+{
+    uint32_t in_size = p->next_packet_size;
+    size_t page_size = qemu_target_page_size();
+    uint32_t flags = p->flags & MULTIFD_FLAG_COMPRESSION_MASK;
+    struct lz4_data *z = p->data;
+    uint32_t pos = 0;
+    int ret;
+    int i;
+
+    if (flags != MULTIFD_FLAG_LZ4) {
+        error_setg(errp, "multifd %u: flags received %x flags expected %x",
+                   p->id, flags, MULTIFD_FLAG_LZ4);
+        return -1;
+    }
+    if (in_size > z->zbuff_len) {
+        error_setg(errp, "multifd %u: packet size received %u size max %u",
+                   p->id, in_size, z->zbuff_len);
+        return -1;
+    }
+    ret = qio_channel_read_all(p->c, (void *)z->zbuff, in_size, errp);
+
+    if (ret != 0) {
+        return ret;
+    }
+
+    for (i = 0; i < p->normal_num; i++) {
+        void *dst = p->host + p->normal[i];
+        uint32_t len;
+
+        if (in_size - pos < LZ4_HDR_SIZE) {
+            break;
+        }
+        len = ldl_be_p(z->zbuff + pos);
+        pos += LZ4_HDR_SIZE;
+        if (len > page_size || len > in_size - pos) {
+            break;
+        }
+
+        if (len == page_size) {
+            memcpy(dst, z->zbuff + pos, page_size);
+        } else {
+            ret = LZ4_decompress_safe((const char *)z->zbuff + pos, dst,
+                                      len, page_size);
+            if (ret != page_size) {
+                error_setg(errp, "multifd %u: lz4 decompression of page %d "
+                           "failed with %d", p->id, i, ret);
+                return -1;
+            }
+        }
+        pos += len;
+    }
+    if (i != p->normal_num || pos != in_size) {
+        error_setg(errp, "multifd %u: packet size received %u size used %u",
+                   p->id, in_size, pos);
+        return -1;
+    }
+    return 0;
+}
+
+static MultiFDMethods multifd_lz4_ops = {
+    .send_setup = lz4_send_setup,
+    .send_cleanup = lz4_send_cleanup,
+    .send_prepare = lz4_send_prepare,
+    .recv_setup = lz4_recv_setup,
+    .recv_cleanup = lz4_recv_cleanup,
+    .recv_pages = lz4_recv_pages
+};
+
+static void multifd_lz4_register(void)
+{
+    multifd_register_ops(MULTIFD_COMPRESSION_LZ4, &multifd_lz4_ops);
+}
+
+migration_init(multifd_lz4_register);
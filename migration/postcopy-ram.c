@@ -553,6 +553,11 @@ static void postcopy_temp_pages_cleanup(MigrationIncomingState *mis)
                        mis->largest_page_size);
                 mis->postcopy_tmp_pages[i].tmp_huge_page = NULL;
             }
+            if (mis->postcopy_tmp_pages[i].batch_buf) {
+                munmap(mis->postcopy_tmp_pages[i].batch_buf,
+                       POSTCOPY_BATCH_SIZE);
+                mis->postcopy_tmp_pages[i].batch_buf = NULL;
+            }
         }
         g_free(mis->postcopy_tmp_pages);
         mis->postcopy_tmp_pages = NULL;
@@ -1138,6 +1143,23 @@ static int postcopy_temp_pages_setup(MigrationIncomingState *mis)
         postcopy_temp_page_reset(tmp_page);
     }
 
+    /*
+     * Background pages mostly arrive in address order on the precopy
+     * channel; gather them so they can be placed several at a time.
+     * Urgent pages on the preempt channel are always placed right away.
+     */
+    tmp_page = &mis->postcopy_tmp_pages[RAM_CHANNEL_PRECOPY];
+    temp_page = mmap(NULL, POSTCOPY_BATCH_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (temp_page == MAP_FAILED) {
+        err = errno;
+        error_report("%s: Failed to map postcopy batch buffer: %s",
+                     __func__, strerror(err));
+        return -err;
+    }
+    tmp_page->batch_buf = temp_page;
+    tmp_page->batch_len = 0;
+
     /*
      * Map large zero page when kernel can't use UFFDIO_ZEROPAGE for hugepages
      */
@@ -1214,41 +1236,55 @@ int postcopy_ram_incoming_setup(MigrationIncomingState *mis)
     return 0;
 }
 
+/*
+ * Install @len bytes at @host_addr, either copied from @from_addr or
+ * zeroed when @from_addr is NULL.  @len is a multiple of the host page
+ * size of @rb.
+ */
 static int qemu_ufd_copy_ioctl(MigrationIncomingState *mis, void *host_addr,
-                               void *from_addr, uint64_t pagesize, RAMBlock *rb)
+                               void *from_addr, uint64_t len, RAMBlock *rb)
 {
     int userfault_fd = mis->userfault_fd;
+    uint64_t pagesize = qemu_ram_pagesize(rb);
+    uint64_t done;
     int ret;
 
     if (from_addr) {
         struct uffdio_copy copy_struct;
         copy_struct.dst = (uint64_t)(uintptr_t)host_addr;
         copy_struct.src = (uint64_t)(uintptr_t)from_addr;
-        copy_struct.len = pagesize;
+        copy_struct.len = len;
         copy_struct.mode = 0;
         ret = ioctl(userfault_fd, UFFDIO_COPY, &copy_struct);
     } else {
         struct uffdio_zeropage zero_struct;
         zero_struct.range.start = (uint64_t)(uintptr_t)host_addr;
-        zero_struct.range.len = pagesize;
+        zero_struct.range.len = len;
         zero_struct.mode = 0;
         ret = ioctl(userfault_fd, UFFDIO_ZEROPAGE, &zero_struct);
     }
     if (!ret) {
         qemu_mutex_lock(&mis->page_request_mutex);
         ramblock_recv_bitmap_set_range(rb, host_addr,
-                                       pagesize / qemu_target_page_size());
+                                       len / qemu_target_page_size());
         /*
-         * If this page resolves a page fault for a previous recorded faulted
-         * address, take a special note to maintain the requested page list.
+         * If these pages resolve page faults for previous recorded faulted
+         * addresses, take a special note to maintain the requested page list.
          */
-        if (g_tree_lookup(mis->page_requested, host_addr)) {
-            g_tree_remove(mis->page_requested, host_addr);
-            mis->page_requested_count--;
-            trace_postcopy_page_req_del(host_addr, mis->page_requested_count);
+        for (done = 0; done < len && mis->page_requested_count;
+             done += pagesize) {
+            void *addr = host_addr + done;
+
+            if (g_tree_lookup(mis->page_requested, addr)) {
+                g_tree_remove(mis->page_requested, addr);
+                mis->page_requested_count--;
+                trace_postcopy_page_req_del(addr, mis->page_requested_count);
+            }
         }
         qemu_mutex_unlock(&mis->page_request_mutex);
-        mark_postcopy_blocktime_end((uintptr_t)host_addr);
+        for (done = 0; done < len; done += pagesize) {
+            mark_postcopy_blocktime_end((uintptr_t)host_addr + done);
+        }
     }
     return ret;
 }
@@ -1270,30 +1306,50 @@ int postcopy_notify_shared_wake(RAMBlock *rb, uint64_t offset)
 }
 
 /*
- * Place a host page (from) at (host) atomically
+ * Place contiguous host pages (from) at (host) atomically, with a single
+ * UFFDIO_COPY; len must be a multiple of the host page size of rb
  * returns 0 on success
  */
-int postcopy_place_page(MigrationIncomingState *mis, void *host, void *from,
-                        RAMBlock *rb)
+int postcopy_place_pages(MigrationIncomingState *mis, void *host, void *from,
+                         size_t len, RAMBlock *rb)
 {
     size_t pagesize = qemu_ram_pagesize(rb);
+    size_t done;
+    int ret;
 
     /* copy also acks to the kernel waking the stalled thread up
      * TODO: We can inhibit that ack and only do it if it was requested
      * which would be slightly cheaper, but we'd have to be careful
      * of the order of updating our page state.
      */
-    if (qemu_ufd_copy_ioctl(mis, host, from, pagesize, rb)) {
+    if (qemu_ufd_copy_ioctl(mis, host, from, len, rb)) {
         int e = errno;
         error_report("%s: %s copy host: %p from: %p (size: %zd)",
-                     __func__, strerror(e), host, from, pagesize);
+                     __func__, strerror(e), host, from, len);
 
         return -e;
     }
 
-    trace_postcopy_place_page(host);
-    return postcopy_notify_shared_wake(rb,
-                                       qemu_ram_block_host_offset(rb, host));
+    trace_postcopy_place_pages(host, len);
+    for (done = 0; done < len; done += pagesize) {
+        ret = postcopy_notify_shared_wake(rb,
+                                          qemu_ram_block_host_offset(rb,
+                                                             host + done));
+        if (ret) {
+            return ret;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Place a host page (from) at (host) atomically
+ * returns 0 on success
+ */
+int postcopy_place_page(MigrationIncomingState *mis, void *host, void *from,
+                        RAMBlock *rb)
+{
+    return postcopy_place_pages(mis, host, from, qemu_ram_pagesize(rb), rb);
 }
 
 /*
@@ -1375,6 +1431,13 @@ int postcopy_place_page(MigrationIncomingState *mis, void *host, void *from,
     return -1;
 }
 
+int postcopy_place_pages(MigrationIncomingState *mis, void *host, void *from,
+                         size_t len, RAMBlock *rb)
+{
+    assert(0);
+    return -1;
+}
+
 int postcopy_place_page_zero(MigrationIncomingState *mis, void *host,
                         RAMBlock *rb)
 {
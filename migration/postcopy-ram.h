@@ -71,6 +71,22 @@ void postcopy_discard_send_finish(MigrationState *ms);
 int postcopy_place_page(MigrationIncomingState *mis, void *host, void *from,
                         RAMBlock *rb);
 
+/*
+ * Place len bytes of contiguous pages (from) at (host) with a single
+ * UFFDIO_COPY; len must be a multiple of the host page size of rb.
+ * returns 0 on success
+ */
+int postcopy_place_pages(MigrationIncomingState *mis, void *host, void *from,
+                         size_t len, RAMBlock *rb);
+
+/*
+ * Largest run of small pages received on the precopy channel that is
+ * placed at once by ram_load_postcopy.  A batch only grows while the
+ * next page is already in the QEMUFile buffer, so it can never outgrow
+ * the read-ahead.
+ */
+#define POSTCOPY_BATCH_SIZE IO_BUF_SIZE
+
 /*
  * Place a zero page at (host) atomically
  * returns 0 on success
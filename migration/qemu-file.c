@@ -31,7 +31,6 @@
 #include "trace.h"
 #include "qapi/error.h"
 
-#define IO_BUF_SIZE 32768
 #define MAX_IOV_SIZE MIN_CONST(IOV_MAX, 64)
 
 struct QEMUFile {
@@ -559,6 +558,60 @@ void qemu_put_buffer(QEMUFile *f, const uint8_t *buf, size_t size)
     }
 }
 
+void qemu_put_buffer_at(QEMUFile *f, const uint8_t *buf, size_t buflen,
+                        off_t pos)
+{
+    Error *err = NULL;
+    size_t done = 0;
+
+    if (f->last_error) {
+        return;
+    }
+
+    while (done < buflen) {
+        ssize_t ret = qio_channel_pwrite(f->ioc, (const char *)buf + done,
+                                         buflen - done, pos + done, &err);
+        if (ret <= 0) {
+            if (!err) {
+                error_setg(&err, "Short write to migration file");
+            }
+            qemu_file_set_error_obj(f, -EIO, err);
+            return;
+        }
+        done += ret;
+    }
+
+    f->rate_limit_used += buflen;
+    f->total_transferred += buflen;
+}
+
+size_t qemu_get_buffer_at(QEMUFile *f, uint8_t *buf, size_t buflen,
+                          off_t pos)
+{
+    Error *err = NULL;
+    size_t done = 0;
+
+    if (f->last_error) {
+        return 0;
+    }
+
+    while (done < buflen) {
+        ssize_t ret = qio_channel_pread(f->ioc, (char *)buf + done,
+                                        buflen - done, pos + done, &err);
+        if (ret <= 0) {
+            if (!err) {
+                error_setg(&err, "Unexpected end of migration file");
+            }
+            qemu_file_set_error_obj(f, -EIO, err);
+            break;
+        }
+        done += ret;
+    }
+
+    f->total_transferred += done;
+    return done;
+}
+
 void qemu_put_byte(QEMUFile *f, int v)
 {
     if (f->last_error) {
@@ -692,6 +745,11 @@ size_t qemu_get_buffer_in_place(QEMUFile *f, uint8_t **buf, size_t size)
     return qemu_get_buffer(f, *buf, size);
 }
 
+size_t qemu_file_buffered_bytes(QEMUFile *f)
+{
+    return f->buf_size - f->buf_index;
+}
+
 /*
  * Peeks a single byte from the buffer; this isn't guaranteed to work if
  * offset leaves a gap after the previous read/peeked data.
@@ -722,6 +780,46 @@ int qemu_get_byte(QEMUFile *f)
     return result;
 }
 
+bool qemu_file_is_seekable(QEMUFile *f)
+{
+    return qio_channel_has_feature(f->ioc, QIO_CHANNEL_FEATURE_SEEKABLE);
+}
+
+off_t qemu_get_offset(QEMUFile *f)
+{
+    Error *err = NULL;
+    off_t ret;
+
+    qemu_fflush(f);
+
+    ret = qio_channel_io_seek(f->ioc, 0, SEEK_CUR, &err);
+    if (ret < 0) {
+        qemu_file_set_error_obj(f, -EIO, err);
+        return ret;
+    }
+    /* Data read ahead into the buffer has not been consumed yet */
+    if (!qemu_file_is_writable(f)) {
+        ret -= f->buf_size - f->buf_index;
+    }
+    return ret;
+}
+
+void qemu_set_offset(QEMUFile *f, off_t off)
+{
+    Error *err = NULL;
+
+    if (qemu_file_is_writable(f)) {
+        qemu_fflush(f);
+    } else {
+        f->buf_index = 0;
+        f->buf_size = 0;
+    }
+
+    if (qio_channel_io_seek(f->ioc, off, SEEK_SET, &err) < 0) {
+        qemu_file_set_error_obj(f, -EIO, err);
+    }
+}
+
 int64_t qemu_file_total_transferred_fast(QEMUFile *f)
 {
     int64_t ret = f->total_transferred;
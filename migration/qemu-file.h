@@ -36,6 +36,9 @@
  */
 typedef int (QEMURamHookFunc)(QEMUFile *f, uint64_t flags, void *data);
 
+/* Size of the read-ahead buffer of a QEMUFile */
+#define IO_BUF_SIZE 32768
+
 /*
  * Constants used by ram_control_* hooks
  */
@@ -105,6 +108,23 @@ void qemu_put_buffer_async(QEMUFile *f, const uint8_t *buf, size_t size,
                            bool may_free);
 bool qemu_file_mode_is_not_valid(const char *mode);
 bool qemu_file_is_writable(QEMUFile *f);
+bool qemu_file_is_seekable(QEMUFile *f);
+
+/*
+ * Positioned I/O for seekable files.  The data is written to or read
+ * from @pos directly, bypassing the buffer and without moving the
+ * stream position.
+ */
+void qemu_put_buffer_at(QEMUFile *f, const uint8_t *buf, size_t buflen,
+                        off_t pos);
+size_t qemu_get_buffer_at(QEMUFile *f, uint8_t *buf, size_t buflen,
+                          off_t pos);
+/*
+ * Stream position of a seekable file, and a way to move it.  Moving the
+ * position flushes pending writes or drops data read ahead.
+ */
+off_t qemu_get_offset(QEMUFile *f);
+void qemu_set_offset(QEMUFile *f, off_t off);
 
 #include "migration/qemu-file-types.h"
 
@@ -121,6 +141,11 @@ int qemu_put_qemu_file(QEMUFile *f_des, QEMUFile *f_src);
  */
 int qemu_peek_byte(QEMUFile *f, int offset);
 void qemu_file_skip(QEMUFile *f, int size);
+/*
+ * Number of bytes already read from the channel and not consumed yet,
+ * i.e. that can be got without blocking.
+ */
+size_t qemu_file_buffered_bytes(QEMUFile *f);
 /*
  * qemu_file_credit_transfer:
  *
@@ -83,6 +83,23 @@
 /* 0x80 is reserved in migration.h start with 0x100 next */
 #define RAM_SAVE_FLAG_COMPRESS_PAGE    0x100
 
+/*
+ * Upper bound on what precedes a page's data on the postcopy stream:
+ * address and flags, RAMBlock id and, for compressed pages, the length
+ * and the compressBound() overhead.
+ */
+#define POSTCOPY_PAGE_HDR_MAX  512
+
+/*
+ * With mapped-ram, each RAMBlock in the RAM_SAVE_FLAG_MEM_SIZE list is
+ * followed by a header (version, page size, bitmap offset and pages
+ * offset) and the stream then skips over the bitmap and pages regions
+ * of the block in the file.  The regions are aligned so that they can
+ * be read with O_DIRECT or mapped.
+ */
+#define MAPPED_RAM_HDR_VERSION 1
+#define MAPPED_RAM_FILE_OFFSET_ALIGNMENT 0x100000
+
 XBZRLECacheStats xbzrle_counters;
 
 /* struct contains XBZRLE cache and a static page
@@ -1402,6 +1419,40 @@ static int ram_save_page(RAMState *rs, PageSearchStatus *pss)
     return pages;
 }
 
+/*
+ * ram_save_mapped_page: write the page at its offset in the file
+ *
+ * Returns the number of pages written.
+ *
+ * Zero pages are not written, only cleared in the file bitmap: the
+ * destination reads back the pages whose bit is set and leaves the
+ * others as they are.
+ *
+ * @rs: current RAM state
+ * @block: block that contains the page we want to send
+ * @offset: offset inside the block for the page
+ */
+static int ram_save_mapped_page(RAMState *rs, RAMBlock *block,
+                                ram_addr_t offset)
+{
+    unsigned long page = offset >> TARGET_PAGE_BITS;
+    uint8_t *p = block->host + offset;
+
+    if (buffer_is_zero(p, TARGET_PAGE_SIZE)) {
+        clear_bit(page, block->file_bmap);
+        ram_counters.duplicate++;
+        return 1;
+    }
+
+    qemu_put_buffer_at(rs->f, p, TARGET_PAGE_SIZE,
+                       block->pages_offset + offset);
+    set_bit(page, block->file_bmap);
+    ram_transferred_add(TARGET_PAGE_SIZE);
+    ram_counters.normal++;
+
+    return 1;
+}
+
 static int ram_save_multifd_page(RAMState *rs, RAMBlock *block,
                                  ram_addr_t offset)
 {
@@ -2281,27 +2332,19 @@ static int ram_save_target_page(RAMState *rs, PageSearchStatus *pss)
 {
     RAMBlock *block = pss->block;
     ram_addr_t offset = ((ram_addr_t)pss->page) << TARGET_PAGE_BITS;
+    bool use_multifd;
     int res;
 
     if (control_save_page(rs, block, offset, &res)) {
         return res;
     }
 
-    if (save_compress_page(rs, block, offset)) {
-        return 1;
+    if (migrate_mapped_ram()) {
+        return ram_save_mapped_page(rs, block, offset);
     }
 
-    res = save_zero_page(rs, block, offset);
-    if (res > 0) {
-        /* Must let xbzrle know, otherwise a previous (now 0'd) cached
-         * page would be stale
-         */
-        if (!save_page_use_compression(rs)) {
-            XBZRLE_cache_lock();
-            xbzrle_cache_zero_page(rs, block->offset + offset);
-            XBZRLE_cache_unlock();
-        }
-        return res;
+    if (save_compress_page(rs, block, offset)) {
+        return 1;
     }
 
     /*
@@ -2310,7 +2353,25 @@ static int ram_save_target_page(RAMState *rs, PageSearchStatus *pss)
      * if host page size == guest page size the dest guest during run may
      * still see partially copied pages which is data corruption.
      */
-    if (migrate_use_multifd() && !migration_in_postcopy()) {
+    use_multifd = migrate_use_multifd() && !migration_in_postcopy();
+
+    /* The multifd channels can look for zero pages themselves */
+    if (!use_multifd || !migrate_multifd_zero_page()) {
+        res = save_zero_page(rs, block, offset);
+        if (res > 0) {
+            /* Must let xbzrle know, otherwise a previous (now 0'd) cached
+             * page would be stale
+             */
+            if (!save_page_use_compression(rs)) {
+                XBZRLE_cache_lock();
+                xbzrle_cache_zero_page(rs, block->offset + offset);
+                XBZRLE_cache_unlock();
+            }
+            return res;
+        }
+    }
+
+    if (use_multifd) {
         return ram_save_multifd_page(rs, block, offset);
     }
 
@@ -2692,6 +2753,11 @@ static void ram_save_cleanup(void *opaque)
         block->bmap = NULL;
     }
 
+    RAMBLOCK_FOREACH_MIGRATABLE(block) {
+        g_free(block->file_bmap);
+        block->file_bmap = NULL;
+    }
+
     xbzrle_cleanup();
     compress_threads_save_cleanup();
     ram_state_cleanup(rsp);
@@ -3198,6 +3264,47 @@ void qemu_guest_free_page_hint(void *addr, size_t len)
  * granularity of these critical sections.
  */
 
+/*
+ * Reserve the bitmap and pages regions of @block in the file, describe
+ * them in the stream, and continue the stream after them.
+ */
+static void mapped_ram_setup_ramblock(QEMUFile *f, RAMBlock *block)
+{
+    unsigned long num_pages = block->used_length >> TARGET_PAGE_BITS;
+    size_t bitmap_size = BITS_TO_LONGS(num_pages) * sizeof(unsigned long);
+    off_t header_end = qemu_get_offset(f) + sizeof(uint32_t) +
+                       3 * sizeof(uint64_t);
+
+    block->file_bmap = bitmap_new(num_pages);
+    block->bitmap_offset = QEMU_ALIGN_UP(header_end,
+                                         MAPPED_RAM_FILE_OFFSET_ALIGNMENT);
+    block->pages_offset = QEMU_ALIGN_UP(block->bitmap_offset + bitmap_size,
+                                        MAPPED_RAM_FILE_OFFSET_ALIGNMENT);
+
+    qemu_put_be32(f, MAPPED_RAM_HDR_VERSION);
+    qemu_put_be64(f, TARGET_PAGE_SIZE);
+    qemu_put_be64(f, block->bitmap_offset);
+    qemu_put_be64(f, block->pages_offset);
+
+    qemu_set_offset(f, block->pages_offset + block->used_length);
+}
+
+/* Write the file bitmaps, once every page has been saved */
+static void mapped_ram_save_bitmaps(QEMUFile *f)
+{
+    RAMBlock *block;
+
+    RAMBLOCK_FOREACH_MIGRATABLE(block) {
+        unsigned long num_pages = block->used_length >> TARGET_PAGE_BITS;
+        size_t bitmap_size = BITS_TO_LONGS(num_pages) * sizeof(unsigned long);
+        g_autofree unsigned long *le_bitmap = bitmap_new(num_pages);
+
+        bitmap_to_le(le_bitmap, block->file_bmap, num_pages);
+        qemu_put_buffer_at(f, (uint8_t *)le_bitmap, bitmap_size,
+                           block->bitmap_offset);
+    }
+}
+
 /**
  * ram_save_setup: Setup RAM for migration
  *
@@ -3212,6 +3319,12 @@ static int ram_save_setup(QEMUFile *f, void *opaque)
     RAMBlock *block;
     int ret;
 
+    if (migrate_mapped_ram() && !qemu_file_is_seekable(f)) {
+        error_report("mapped-ram requires a seekable migration channel, "
+                     "e.g. a file: URI");
+        return -1;
+    }
+
     if (compress_threads_save_setup()) {
         return -1;
     }
@@ -3239,6 +3352,9 @@ static int ram_save_setup(QEMUFile *f, void *opaque)
             if (migrate_ignore_shared()) {
                 qemu_put_be64(f, block->mr->addr);
             }
+            if (migrate_mapped_ram()) {
+                mapped_ram_setup_ramblock(f, block);
+            }
         }
     }
 
@@ -3422,6 +3538,10 @@ static int ram_save_complete(QEMUFile *f, void *opaque)
 
         flush_compressed_data(rs);
         ram_control_after_iterate(f, RAM_CONTROL_FINISH);
+
+        if (!ret && migrate_mapped_ram()) {
+            mapped_ram_save_bitmaps(f);
+        }
     }
 
     if (ret < 0) {
@@ -3957,6 +4077,23 @@ int ram_postcopy_incoming_init(MigrationIncomingState *mis)
     return postcopy_ram_incoming_init(mis);
 }
 
+/*
+ * Place the run of pages gathered on the precopy channel, if any.
+ */
+static int ram_load_postcopy_flush_batch(MigrationIncomingState *mis,
+                                         PostcopyTmpPage *tmp_page)
+{
+    int ret;
+
+    if (!tmp_page->batch_len) {
+        return 0;
+    }
+    ret = postcopy_place_pages(mis, tmp_page->batch_host, tmp_page->batch_buf,
+                               tmp_page->batch_len, tmp_page->batch_block);
+    tmp_page->batch_len = 0;
+    return ret;
+}
+
 /**
  * ram_load_postcopy: load a page in postcopy case
  *
@@ -3981,9 +4118,23 @@ int ram_load_postcopy(QEMUFile *f, int channel)
         void *page_buffer = NULL;
         void *place_source = NULL;
         RAMBlock *block = NULL;
+        bool batched = false;
         uint8_t ch;
         int len;
 
+        /*
+         * Never sit on received pages while waiting for the source: a
+         * vCPU may be faulting on one of them.  Unless the next page is
+         * already buffered, place what we have before reading on.
+         */
+        if (tmp_page->batch_len && qemu_file_buffered_bytes(f) <
+            TARGET_PAGE_SIZE + POSTCOPY_PAGE_HDR_MAX) {
+            ret = ram_load_postcopy_flush_batch(mis, tmp_page);
+            if (ret) {
+                break;
+            }
+        }
+
         addr = qemu_get_be64(f);
 
         /*
@@ -4080,6 +4231,30 @@ int ram_load_postcopy(QEMUFile *f, int channel)
             if (!matches_target_page_size) {
                 /* For huge pages, we always use temporary buffer */
                 qemu_get_buffer(f, page_buffer, TARGET_PAGE_SIZE);
+            } else if (tmp_page->batch_buf) {
+                /*
+                 * Background pages are read straight into the batch,
+                 * which is placed once full or when this page does not
+                 * extend it.
+                 */
+                if (tmp_page->batch_len &&
+                    (tmp_page->batch_block != block ||
+                     tmp_page->batch_host + tmp_page->batch_len !=
+                     tmp_page->host_addr ||
+                     tmp_page->batch_len == POSTCOPY_BATCH_SIZE)) {
+                    ret = ram_load_postcopy_flush_batch(mis, tmp_page);
+                    if (ret) {
+                        break;
+                    }
+                }
+                if (!tmp_page->batch_len) {
+                    tmp_page->batch_block = block;
+                    tmp_page->batch_host = tmp_page->host_addr;
+                }
+                qemu_get_buffer(f, tmp_page->batch_buf + tmp_page->batch_len,
+                                TARGET_PAGE_SIZE);
+                tmp_page->batch_len += TARGET_PAGE_SIZE;
+                batched = true;
             } else {
                 /*
                  * For small pages that matches target page size, we
@@ -4106,6 +4281,7 @@ int ram_load_postcopy(QEMUFile *f, int channel)
 
         case RAM_SAVE_FLAG_EOS:
             /* normal exit */
+            ret = ram_load_postcopy_flush_batch(mis, tmp_page);
             multifd_recv_sync_main();
             break;
         default:
@@ -4128,7 +4304,7 @@ int ram_load_postcopy(QEMUFile *f, int channel)
         if (!ret && place_needed) {
             if (tmp_page->all_zero) {
                 ret = postcopy_place_page_zero(mis, tmp_page->host_addr, block);
-            } else {
+            } else if (!batched) {
                 ret = postcopy_place_page(mis, tmp_page->host_addr,
                                           place_source, block);
             }
@@ -4137,6 +4313,11 @@ int ram_load_postcopy(QEMUFile *f, int channel)
         }
     }
 
+    if (ret) {
+        /* Pages not placed yet are sent again after a postcopy recovery */
+        tmp_page->batch_len = 0;
+    }
+
     return ret;
 }
 
@@ -4201,6 +4382,86 @@ void colo_flush_ram_cache(void)
     trace_colo_flush_ram_cache_end();
 }
 
+/*
+ * mapped_ram_read_ramblock: load a block saved with mapped-ram
+ *
+ * Returns 0 for success or a negative error code
+ *
+ * Reads the header of @block from the stream, then its file bitmap, and
+ * each run of pages whose bit is set straight into guest memory with a
+ * single positioned read.
+ *
+ * @f: QEMUFile where to read the data from
+ * @block: block that is being loaded
+ * @length: length of the block on the source
+ */
+static int mapped_ram_read_ramblock(QEMUFile *f, RAMBlock *block,
+                                    ram_addr_t length)
+{
+    unsigned long num_pages = length >> TARGET_PAGE_BITS;
+    size_t bitmap_size = BITS_TO_LONGS(num_pages) * sizeof(unsigned long);
+    g_autofree unsigned long *le_bitmap = NULL;
+    g_autofree unsigned long *bitmap = NULL;
+    uint64_t page_size, bitmap_offset, pages_offset;
+    unsigned long set, clear;
+    uint32_t version;
+
+    version = qemu_get_be32(f);
+    page_size = qemu_get_be64(f);
+    bitmap_offset = qemu_get_be64(f);
+    pages_offset = qemu_get_be64(f);
+
+    if (version != MAPPED_RAM_HDR_VERSION) {
+        error_report("Unsupported mapped-ram header version %u for block %s",
+                     version, block->idstr);
+        return -EINVAL;
+    }
+    if (page_size != TARGET_PAGE_SIZE) {
+        error_report("Mismatched mapped-ram page size for block %s "
+                     "%" PRIu64 " != %d", block->idstr, page_size,
+                     TARGET_PAGE_SIZE);
+        return -EINVAL;
+    }
+    if (!qemu_file_is_seekable(f)) {
+        error_report("mapped-ram requires a seekable migration channel, "
+                     "e.g. a file: URI");
+        return -EINVAL;
+    }
+
+    le_bitmap = bitmap_new(num_pages);
+    bitmap = bitmap_new(num_pages);
+    if (qemu_get_buffer_at(f, (uint8_t *)le_bitmap, bitmap_size,
+                           bitmap_offset) != bitmap_size) {
+        return -EIO;
+    }
+    bitmap_from_le(bitmap, le_bitmap, num_pages);
+
+    for (set = find_first_bit(bitmap, num_pages); set < num_pages;
+         set = find_next_bit(bitmap, num_pages, clear + 1)) {
+        ram_addr_t offset = (ram_addr_t)set << TARGET_PAGE_BITS;
+        size_t len;
+        void *host;
+
+        clear = find_next_zero_bit(bitmap, num_pages, set + 1);
+        len = (clear - set) << TARGET_PAGE_BITS;
+
+        host = host_from_ram_block_offset(block, offset);
+        if (!host || !offset_in_ramblock(block, offset + len - 1)) {
+            error_report("Illegal RAM offset " RAM_ADDR_FMT, offset);
+            return -EINVAL;
+        }
+        if (qemu_get_buffer_at(f, host, len, pages_offset + offset) != len) {
+            return -EIO;
+        }
+        ramblock_recv_bitmap_set_range(block, host, clear - set);
+    }
+
+    /* The stream continues after the regions of this block */
+    qemu_set_offset(f, pages_offset + length);
+
+    return qemu_file_get_error(f);
+}
+
 /**
  * ram_load_precopy: load pages in precopy case
  *
@@ -4342,6 +4603,9 @@ static int ram_load_precopy(QEMUFile *f)
                             ret = -EINVAL;
                         }
                     }
+                    if (!ret && migrate_mapped_ram()) {
+                        ret = mapped_ram_read_ramblock(f, block, length);
+                    }
                     ram_control_load_hook(f, RAM_CONTROL_BLOCK_REG,
                                           block->idstr);
                 } else {
@@ -214,6 +214,8 @@ typedef struct SaveStateEntry {
     void *opaque;
     CompatEntry *compat;
     int is_ram;
+    /* us spent in the last full save or load of the section, -1 if none */
+    int64_t state_time_us;
 } SaveStateEntry;
 
 typedef struct SaveState {
@@ -757,6 +759,7 @@ int register_savevm_live(const char *idstr,
     SaveStateEntry *se;
 
     se = g_new0(SaveStateEntry, 1);
+    se->state_time_us = -1;
     se->version_id = version_id;
     se->section_id = savevm_state.global_section_id++;
     se->ops = ops;
@@ -815,6 +818,7 @@ int vmstate_register_with_alias_id(VMStateIf *obj, uint32_t instance_id,
     assert(alias_id == -1 || required_for_version >= vmsd->minimum_version_id);
 
     se = g_new0(SaveStateEntry, 1);
+    se->state_time_us = -1;
     se->version_id = vmsd->version_id;
     se->section_id = savevm_state.global_section_id++;
     se->opaque = opaque;
@@ -1135,6 +1139,57 @@ void qemu_savevm_non_migratable_list(strList **reasons)
     }
 }
 
+static void savevm_reset_state_times(void)
+{
+    SaveStateEntry *se;
+
+    QTAILQ_FOREACH(se, &savevm_state.handlers, entry) {
+        se->state_time_us = -1;
+    }
+}
+
+static gint savevm_state_time_cmp(gconstpointer a, gconstpointer b)
+{
+    const SaveStateEntry *sa = *(SaveStateEntry * const *)a;
+    const SaveStateEntry *sb = *(SaveStateEntry * const *)b;
+
+    /* Slowest first */
+    return sa->state_time_us < sb->state_time_us ? 1 :
+           sa->state_time_us > sb->state_time_us ? -1 : 0;
+}
+
+/*
+ * Report the time each device took to save or load its state during the
+ * last migration or snapshot, slowest first.
+ */
+void populate_device_state_info(MigrationInfo *info)
+{
+    g_autoptr(GPtrArray) entries = g_ptr_array_new();
+    SaveStateEntry *se;
+    int i;
+
+    if (info->has_device_state) {
+        return;
+    }
+    QTAILQ_FOREACH(se, &savevm_state.handlers, entry) {
+        if (se->state_time_us >= 0) {
+            g_ptr_array_add(entries, se);
+        }
+    }
+    g_ptr_array_sort(entries, savevm_state_time_cmp);
+
+    for (i = (int)entries->len - 1; i >= 0; i--) {
+        DeviceStateTiming *t = g_new0(DeviceStateTiming, 1);
+
+        se = g_ptr_array_index(entries, i);
+        t->idstr = g_strdup(se->idstr);
+        t->instance_id = se->instance_id;
+        t->time = se->state_time_us;
+        QAPI_LIST_PREPEND(info->device_state, t);
+    }
+    info->has_device_state = info->device_state != NULL;
+}
+
 void qemu_savevm_state_header(QEMUFile *f)
 {
     trace_savevm_state_header();
@@ -1373,7 +1428,9 @@ int qemu_savevm_state_complete_precopy_non_iterable(QEMUFile *f,
     json_writer_start_object(vmdesc, NULL);
     json_writer_int64(vmdesc, "page_size", qemu_target_page_size());
     json_writer_start_array(vmdesc, "devices");
+    savevm_reset_state_times();
     QTAILQ_FOREACH(se, &savevm_state.handlers, entry) {
+        int64_t start_us;
 
         if ((!se->ops || !se->ops->save_state) && !se->vmsd) {
             continue;
@@ -1389,12 +1446,14 @@ int qemu_savevm_state_complete_precopy_non_iterable(QEMUFile *f,
         json_writer_str(vmdesc, "name", se->idstr);
         json_writer_int64(vmdesc, "instance_id", se->instance_id);
 
+        start_us = qemu_clock_get_us(QEMU_CLOCK_REALTIME);
         save_section_header(f, se, QEMU_VM_SECTION_FULL);
         ret = vmstate_save(f, se, vmdesc);
         if (ret) {
             qemu_file_set_error(f, ret);
             return ret;
         }
+        se->state_time_us = qemu_clock_get_us(QEMU_CLOCK_REALTIME) - start_us;
         trace_savevm_section_end(se->idstr, se->section_id, 0);
         save_section_footer(f, se);
 
@@ -2368,6 +2427,7 @@ qemu_loadvm_section_start_full(QEMUFile *f, MigrationIncomingState *mis)
     uint32_t instance_id, version_id, section_id;
     SaveStateEntry *se;
     char idstr[256];
+    int64_t start_us;
     int ret;
 
     /* Read section start */
@@ -2414,6 +2474,7 @@ qemu_loadvm_section_start_full(QEMUFile *f, MigrationIncomingState *mis)
         return -EINVAL;
     }
 
+    start_us = qemu_clock_get_us(QEMU_CLOCK_REALTIME);
     ret = vmstate_load(f, se);
     if (ret < 0) {
         error_report("error while loading state for instance 0x%"PRIx32" of"
@@ -2423,6 +2484,10 @@ qemu_loadvm_section_start_full(QEMUFile *f, MigrationIncomingState *mis)
     if (!check_section_footer(f, se)) {
         return -EINVAL;
     }
+    /* Iterable sections start here too, only time device state */
+    if (!se->ops || !se->ops->save_live_iterate) {
+        se->state_time_us = qemu_clock_get_us(QEMU_CLOCK_REALTIME) - start_us;
+    }
 
     return 0;
 }
@@ -2703,6 +2768,7 @@ int qemu_loadvm_state(QEMUFile *f)
         return ret;
     }
 
+    savevm_reset_state_times();
     if (qemu_loadvm_state_setup(f) != 0) {
         return -EINVAL;
     }
@@ -334,6 +334,34 @@ void hmp_info_migrate(Monitor *mon, const QDict *qdict)
                        info->compression->compression_rate);
     }
 
+    if (info->has_multifd_channels) {
+        MultiFDChannelStatsList *ch;
+
+        for (ch = info->multifd_channels; ch; ch = ch->next) {
+            monitor_printf(mon, "multifd channel %u: %" PRIu64 " packets, "
+                           "%" PRIu64 " normal pages, %" PRIu64 " zero pages, "
+                           "%" PRIu64 " kbytes, compression rate %0.2f\n",
+                           ch->value->id, ch->value->packets,
+                           ch->value->normal_pages, ch->value->zero_pages,
+                           ch->value->transferred >> 10,
+                           ch->value->compression_rate);
+        }
+    }
+
+    if (info->has_device_state) {
+        DeviceStateTimingList *dev;
+        int n;
+
+        /* Only the slowest ones, query-migrate has them all */
+        monitor_printf(mon, "device state time (slowest first):\n");
+        for (dev = info->device_state, n = 0; dev && n < 10;
+             dev = dev->next, n++) {
+            monitor_printf(mon, "  %s (instance %u): %" PRId64 " us\n",
+                           dev->value->idstr, dev->value->instance_id,
+                           dev->value->time);
+        }
+    }
+
     if (info->has_cpu_throttle_percentage) {
         monitor_printf(mon, "cpu throttle percentage: %" PRIu64 "\n",
                        info->cpu_throttle_percentage);
@@ -478,6 +506,9 @@ void hmp_info_migrate_parameters(Monitor *mon, const QDict *qdict)
         monitor_printf(mon, "%s: %s\n",
             MigrationParameter_str(MIGRATION_PARAMETER_MULTIFD_COMPRESSION),
             MultiFDCompression_str(params->multifd_compression));
+        monitor_printf(mon, "%s: %u\n",
+            MigrationParameter_str(MIGRATION_PARAMETER_MULTIFD_LZ4_LEVEL),
+            params->multifd_lz4_level);
         monitor_printf(mon, "%s: %" PRIu64 " bytes\n",
             MigrationParameter_str(MIGRATION_PARAMETER_XBZRLE_CACHE_SIZE),
             params->xbzrle_cache_size);
@@ -1297,6 +1328,10 @@ void hmp_migrate_set_parameter(Monitor *mon, const QDict *qdict)
         p->has_multifd_zstd_level = true;
         visit_type_uint8(v, param, &p->multifd_zstd_level, &err);
         break;
+    case MIGRATION_PARAMETER_MULTIFD_LZ4_LEVEL:
+        p->has_multifd_lz4_level = true;
+        visit_type_uint8(v, param, &p->multifd_lz4_level, &err);
+        break;
     case MIGRATION_PARAMETER_XBZRLE_CACHE_SIZE:
         p->has_xbzrle_cache_size = true;
         if (!visit_type_size(v, param, &cache_size, &err)) {
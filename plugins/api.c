@@ -41,6 +41,7 @@
 #include "exec/exec-all.h"
 #include "exec/ram_addr.h"
 #include "disas/disas.h"
+#include "exec/gdbstub.h"
 #include "plugin.h"
 #ifndef CONFIG_USER_ONLY
 #include "qemu/plugin-memory.h"
@@ -83,13 +84,24 @@ void qemu_plugin_register_vcpu_exit_cb(qemu_plugin_id_t id,
     plugin_register_cb(id, QEMU_PLUGIN_EV_VCPU_EXIT, cb);
 }
 
+/*
+ * Callbacks that read registers need TCG to sync its globals back to
+ * env before the call, which the regular ones can skip.
+ */
+static enum plugin_dyn_cb_subtype
+udata_cb_subtype(enum qemu_plugin_cb_flags flags)
+{
+    return flags == QEMU_PLUGIN_CB_NO_REGS ?
+        PLUGIN_CB_REGULAR : PLUGIN_CB_REGULAR_R;
+}
+
 void qemu_plugin_register_vcpu_tb_exec_cb(struct qemu_plugin_tb *tb,
                                           qemu_plugin_vcpu_udata_cb_t cb,
                                           enum qemu_plugin_cb_flags flags,
                                           void *udata)
 {
     if (!tb->mem_only) {
-        plugin_register_dyn_cb__udata(&tb->cbs[PLUGIN_CB_REGULAR],
+        plugin_register_dyn_cb__udata(&tb->cbs[udata_cb_subtype(flags)],
                                       cb, flags, udata);
     }
 }
@@ -99,7 +111,18 @@ void qemu_plugin_register_vcpu_tb_exec_inline(struct qemu_plugin_tb *tb,
                                               void *ptr, uint64_t imm)
 {
     if (!tb->mem_only) {
-        plugin_register_inline_op(&tb->cbs[PLUGIN_CB_INLINE], 0, op, ptr, imm);
+        plugin_register_inline_op(&tb->cbs[PLUGIN_CB_INLINE], 0, op, ptr,
+                                  0, imm);
+    }
+}
+
+void qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu(
+    struct qemu_plugin_tb *tb, enum qemu_plugin_op op,
+    void *ptr, size_t stride, uint64_t imm)
+{
+    if (!tb->mem_only) {
+        plugin_register_inline_op(&tb->cbs[PLUGIN_CB_INLINE], 0, op, ptr,
+                                  stride, imm);
     }
 }
 
@@ -109,7 +132,9 @@ void qemu_plugin_register_vcpu_insn_exec_cb(struct qemu_plugin_insn *insn,
                                             void *udata)
 {
     if (!insn->mem_only) {
-        plugin_register_dyn_cb__udata(&insn->cbs[PLUGIN_CB_INSN][PLUGIN_CB_REGULAR],
+        enum plugin_dyn_cb_subtype subtype = udata_cb_subtype(flags);
+
+        plugin_register_dyn_cb__udata(&insn->cbs[PLUGIN_CB_INSN][subtype],
                                       cb, flags, udata);
     }
 }
@@ -120,7 +145,17 @@ void qemu_plugin_register_vcpu_insn_exec_inline(struct qemu_plugin_insn *insn,
 {
     if (!insn->mem_only) {
         plugin_register_inline_op(&insn->cbs[PLUGIN_CB_INSN][PLUGIN_CB_INLINE],
-                                  0, op, ptr, imm);
+                                  0, op, ptr, 0, imm);
+    }
+}
+
+void qemu_plugin_register_vcpu_insn_exec_inline_per_vcpu(
+    struct qemu_plugin_insn *insn, enum qemu_plugin_op op,
+    void *ptr, size_t stride, uint64_t imm)
+{
+    if (!insn->mem_only) {
+        plugin_register_inline_op(&insn->cbs[PLUGIN_CB_INSN][PLUGIN_CB_INLINE],
+                                  0, op, ptr, stride, imm);
     }
 }
 
@@ -145,7 +180,15 @@ void qemu_plugin_register_vcpu_mem_inline(struct qemu_plugin_insn *insn,
                                           uint64_t imm)
 {
     plugin_register_inline_op(&insn->cbs[PLUGIN_CB_MEM][PLUGIN_CB_INLINE],
-                              rw, op, ptr, imm);
+                              rw, op, ptr, 0, imm);
+}
+
+void qemu_plugin_register_vcpu_mem_inline_per_vcpu(
+    struct qemu_plugin_insn *insn, enum qemu_plugin_mem_rw rw,
+    enum qemu_plugin_op op, void *ptr, size_t stride, uint64_t imm)
+{
+    plugin_register_inline_op(&insn->cbs[PLUGIN_CB_MEM][PLUGIN_CB_INLINE],
+                              rw, op, ptr, stride, imm);
 }
 
 void qemu_plugin_register_vcpu_tb_trans_cb(qemu_plugin_id_t id,
@@ -387,6 +430,25 @@ int qemu_plugin_n_max_vcpus(void)
 #endif
 }
 
+/*
+ * Register access
+ */
+int qemu_plugin_read_register(unsigned int reg, uint8_t *buf, size_t len)
+{
+    g_autoptr(GByteArray) val = g_byte_array_new();
+    int size;
+
+    g_assert(current_cpu);
+
+    /* gdb_read_register() takes a signed register number */
+    if (reg > INT_MAX) {
+        return 0;
+    }
+    size = gdb_read_register(current_cpu, val, reg);
+    memcpy(buf, val->data, MIN(len, val->len));
+    return size;
+}
+
 /*
  * Plugin output
  */
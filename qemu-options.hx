@@ -184,6 +184,8 @@ DEF("accel", HAS_ARG, QEMU_OPTION_accel,
     "                kvm-shadow-mem=size of KVM shadow MMU in bytes\n"
     "                split-wx=on|off (enable TCG split w^x mapping)\n"
     "                tb-size=n (TCG translation block cache size)\n"
+    "                perfmap=on|off (write /tmp/perf-<pid>.map for TCG code)\n"
+    "                jitdump=on|off (write jit-<pid>.dump for TCG code)\n"
     "                dirty-ring-size=n (KVM dirty ring GFN count, default 0)\n"
     "                notify-vmexit=run|internal-error|disable,notify-window=n (enable notify VM exit and set notify window, x86 only)\n"
     "                thread=single|multi (enable multi-threaded TCG)\n", QEMU_ARCH_ALL)
@@ -219,6 +221,19 @@ SRST
     ``tb-size=n``
         Controls the size (in MiB) of the TCG translation block cache.
 
+    ``perfmap=on|off``
+        Generate a map file for Linux perf tools that will allow basic
+        profiling information to be broken down into translation blocks.
+        The file is written to ``/tmp/perf-<pid>.map``; each entry names
+        the guest PC of the block and, when known, the guest symbol.
+
+    ``jitdump=on|off``
+        Generate a jit-<pid>.dump file in the current directory for Linux
+        perf tools. Unlike a map file, this also records the generated
+        code and when it was generated, so samples remain correct after
+        the translation cache is flushed. Use with ``perf record -k 1``
+        and ``perf inject --jit``.
+
     ``thread=single|multi``
         Controls number of TCG threads. When the TCG is multi-threaded
         there will be one thread per vCPU therefore taking advantage of
@@ -4551,6 +4566,8 @@ DEF("incoming", HAS_ARG, QEMU_OPTION_incoming, \
     "-incoming exec:cmdline\n" \
     "                accept incoming migration on given file descriptor\n" \
     "                or from given external command\n" \
+    "-incoming file:filename\n" \
+    "                accept incoming migration from the given file\n" \
     "-incoming defer\n" \
     "                wait for the URI to be specified via migrate_incoming\n",
     QEMU_ARCH_ALL)
@@ -4570,6 +4587,10 @@ SRST
     Accept incoming migration as an output from specified external
     command.
 
+``-incoming file:filename``
+    Accept incoming migration from the given file, e.g. one saved with
+    the ``mapped-ram`` capability.
+
 ``-incoming defer``
     Wait for the URI to be specified via migrate\_incoming. The monitor
     can be used to change settings (such as migration parameters) prior
@@ -10,6 +10,7 @@
  */
 
 #include "qemu/osdep.h"
+#include "qemu/bswap.h"
 #include "sysemu/replay.h"
 #include "sysemu/runstate.h"
 #include "replay-internal.h"
@@ -44,6 +45,19 @@ static void replay_read_error(void)
     exit(1);
 }
 
+/*
+ * Multi-byte values are stored big-endian.  Write and read them with a
+ * single stdio call each, rather than one locked putc/getc per byte.
+ */
+static void replay_put_bytes(const uint8_t *buf, size_t size)
+{
+    if (replay_file) {
+        if (fwrite(buf, 1, size, replay_file) != size) {
+            replay_write_error();
+        }
+    }
+}
+
 void replay_put_byte(uint8_t byte)
 {
     if (replay_file) {
@@ -62,20 +76,26 @@ void replay_put_event(uint8_t event)
 
 void replay_put_word(uint16_t word)
 {
-    replay_put_byte(word >> 8);
-    replay_put_byte(word);
+    uint8_t buf[2];
+
+    stw_be_p(buf, word);
+    replay_put_bytes(buf, sizeof(buf));
 }
 
 void replay_put_dword(uint32_t dword)
 {
-    replay_put_word(dword >> 16);
-    replay_put_word(dword);
+    uint8_t buf[4];
+
+    stl_be_p(buf, dword);
+    replay_put_bytes(buf, sizeof(buf));
 }
 
 void replay_put_qword(int64_t qword)
 {
-    replay_put_dword(qword >> 32);
-    replay_put_dword(qword);
+    uint8_t buf[8];
+
+    stq_be_p(buf, qword);
+    replay_put_bytes(buf, sizeof(buf));
 }
 
 void replay_put_array(const uint8_t *buf, size_t size)
@@ -101,37 +121,44 @@ uint8_t replay_get_byte(void)
     return byte;
 }
 
-uint16_t replay_get_word(void)
+static void replay_get_bytes(uint8_t *buf, size_t size)
 {
-    uint16_t word = 0;
-    if (replay_file) {
-        word = replay_get_byte();
-        word = (word << 8) + replay_get_byte();
+    if (fread(buf, 1, size, replay_file) != size) {
+        replay_read_error();
     }
+}
 
-    return word;
+uint16_t replay_get_word(void)
+{
+    uint8_t buf[2];
+
+    if (!replay_file) {
+        return 0;
+    }
+    replay_get_bytes(buf, sizeof(buf));
+    return lduw_be_p(buf);
 }
 
 uint32_t replay_get_dword(void)
 {
-    uint32_t dword = 0;
-    if (replay_file) {
-        dword = replay_get_word();
-        dword = (dword << 16) + replay_get_word();
-    }
+    uint8_t buf[4];
 
-    return dword;
+    if (!replay_file) {
+        return 0;
+    }
+    replay_get_bytes(buf, sizeof(buf));
+    return ldl_be_p(buf);
 }
 
 int64_t replay_get_qword(void)
 {
-    int64_t qword = 0;
-    if (replay_file) {
-        qword = replay_get_dword();
-        qword = (qword << 32) + replay_get_dword();
-    }
+    uint8_t buf[8];
 
-    return qword;
+    if (!replay_file) {
+        return 0;
+    }
+    replay_get_bytes(buf, sizeof(buf));
+    return ldq_be_p(buf);
 }
 
 void replay_get_array(uint8_t *buf, size_t *size)
@@ -17,6 +17,7 @@
 #include "replay-internal.h"
 #include "qemu/main-loop.h"
 #include "qemu/option.h"
+#include "qemu/units.h"
 #include "sysemu/cpus.h"
 #include "qemu/error-report.h"
 
@@ -25,6 +26,8 @@
 #define REPLAY_VERSION              0xe0200c
 /* Size of replay log header */
 #define HEADER_SIZE                 (sizeof(uint32_t) + sizeof(uint64_t))
+/* Size of the stdio buffer for the log file */
+#define REPLAY_FILE_BUFFER_SIZE     (1 * MiB)
 
 ReplayMode replay_mode = REPLAY_MODE_NONE;
 char *replay_snapshot;
@@ -251,6 +254,8 @@ static void replay_enable(const char *fname, int mode)
         fprintf(stderr, "Replay: open %s: %s\n", fname, strerror(errno));
         exit(1);
     }
+    /* The log is written and read sequentially; use large stdio buffers. */
+    setvbuf(replay_file, NULL, _IOFBF, REPLAY_FILE_BUFFER_SIZE);
 
     replay_filename = g_strdup(fname);
     replay_mode = mode;
@@ -24,6 +24,7 @@
 
 #include "qemu/osdep.h"
 #include "qemu/cutils.h"
+#include "qemu/host-utils.h"
 #include "migration/vmstate.h"
 #include "qapi/error.h"
 #include "qemu/error-report.h"
@@ -169,11 +170,37 @@ int64_t icount_to_ns(int64_t icount)
  */
 #define ICOUNT_WOBBLE (NANOSECONDS_PER_SECOND / 10)
 
+/*
+ * Estimate the shift that matches the current guest speed, from the
+ * instructions executed and the real time elapsed since the last
+ * adjustment.  This is only meaningful if the vCPU was busy for the
+ * whole interval; warping over idle time changes the bias, in which
+ * case return -1.
+ */
+static int icount_estimate_shift(int64_t cur_time)
+{
+    int64_t insns = timers_state.qemu_icount - timers_state.last_adjust_icount;
+    int64_t ns = cur_time - timers_state.last_adjust_time;
+    int64_t per_insn;
+
+    if (qatomic_read_i64(&timers_state.qemu_icount_bias)
+        != timers_state.last_adjust_bias || insns <= 0 || ns <= 0) {
+        return -1;
+    }
+    per_insn = ns / insns;
+    if (per_insn == 0) {
+        return 0;
+    }
+    /* Round log2 to nearest, placing the midpoint at 1.5 * 2**n.  */
+    return MIN(63 - clz64(per_insn + (per_insn >> 1)), MAX_ICOUNT_SHIFT);
+}
+
 static void icount_adjust(void)
 {
     int64_t cur_time;
     int64_t cur_icount;
     int64_t delta;
+    int shift;
 
     /* If the VM is not running, then do nothing.  */
     if (!runstate_is_running()) {
@@ -187,17 +214,25 @@ static void icount_adjust(void)
     cur_icount = icount_get_locked();
 
     delta = cur_icount - cur_time;
-    /* FIXME: This is a very crude algorithm, somewhat prone to oscillation.  */
-    if (delta > 0
-        && timers_state.last_delta + ICOUNT_WOBBLE < delta * 2
-        && timers_state.icount_time_shift > 0) {
+    /*
+     * If the guest speed is far from the current shift, e.g. just after
+     * startup or when the workload changes, jump straight to an estimate
+     * instead of moving one step per adjustment period.  Otherwise fall
+     * back to nudging the shift by one.
+     * FIXME: This is a very crude algorithm, somewhat prone to oscillation.
+     */
+    shift = icount_estimate_shift(cur_time);
+    if (shift >= 0 && abs(shift - timers_state.icount_time_shift) > 1) {
+        qatomic_set(&timers_state.icount_time_shift, shift);
+    } else if (delta > 0
+               && timers_state.last_delta + ICOUNT_WOBBLE < delta * 2
+               && timers_state.icount_time_shift > 0) {
         /* The guest is getting too far ahead.  Slow time down.  */
         qatomic_set(&timers_state.icount_time_shift,
                     timers_state.icount_time_shift - 1);
-    }
-    if (delta < 0
-        && timers_state.last_delta - ICOUNT_WOBBLE > delta * 2
-        && timers_state.icount_time_shift < MAX_ICOUNT_SHIFT) {
+    } else if (delta < 0
+               && timers_state.last_delta - ICOUNT_WOBBLE > delta * 2
+               && timers_state.icount_time_shift < MAX_ICOUNT_SHIFT) {
         /* The guest is getting too far behind.  Speed time up.  */
         qatomic_set(&timers_state.icount_time_shift,
                     timers_state.icount_time_shift + 1);
@@ -206,6 +241,10 @@ static void icount_adjust(void)
     qatomic_set_i64(&timers_state.qemu_icount_bias,
                     cur_icount - (timers_state.qemu_icount
                                   << timers_state.icount_time_shift));
+    timers_state.last_adjust_icount = timers_state.qemu_icount;
+    timers_state.last_adjust_time = cur_time;
+    timers_state.last_adjust_bias =
+        qatomic_read_i64(&timers_state.qemu_icount_bias);
     seqlock_write_unlock(&timers_state.vm_clock_seqlock,
                          &timers_state.vm_clock_lock);
 }
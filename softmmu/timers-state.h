@@ -45,6 +45,10 @@ typedef struct TimersState {
     int16_t icount_time_shift;
     /* Icount delta used for shift auto adjust. */
     int64_t last_delta;
+    /* Raw icount, real time and bias as of the last shift auto adjust. */
+    int64_t last_adjust_icount;
+    int64_t last_adjust_time;
+    int64_t last_adjust_bias;
 
     /* Compensate for varying guest execution speed.  */
     aligned_int64_t qemu_icount_bias;
@@ -61,6 +61,7 @@
 #include "exec/log.h"
 #include "tcg/tcg-ldst.h"
 #include "tcg-internal.h"
+#include "accel/tcg/perf.h"
 
 #ifdef CONFIG_TCG_INTERPRETER
 #include <ffi.h>
@@ -755,6 +756,8 @@ void tcg_prologue_init(TCGContext *s)
                         (uintptr_t)s->code_buf, prologue_size);
 #endif
 
+    perf_report_prologue(tcg_splitwx_to_rx(s->code_buf), prologue_size);
+
 #ifdef DEBUG_DISAS
     if (qemu_loglevel_mask(CPU_LOG_TB_OUT_ASM)) {
         FILE *logfile = qemu_log_trylock();
@@ -3125,6 +3128,48 @@ static void tcg_reg_free(TCGContext *s, TCGReg reg, TCGRegSet allocated_regs)
     }
 }
 
+/*
+ * Free call-clobbered register 'reg' before a helper call.  If the
+ * temporary it holds will still be valid in a register after the call,
+ * try to move it to a free call-saved register instead of spilling it,
+ * which avoids both the store and the reload after the call.
+ * Globals are only kept if the helper does not write them.
+ */
+static void tcg_reg_free_for_call(TCGContext *s, TCGReg reg,
+                                  TCGRegSet allocated_regs, int call_flags)
+{
+    TCGTemp *ts = s->reg_to_temp[reg];
+    TCGRegSet set;
+    int i, n = ARRAY_SIZE(tcg_target_reg_alloc_order);
+
+    if (ts == NULL) {
+        return;
+    }
+    if (ts->kind == TEMP_CONST ||
+        (ts->kind == TEMP_GLOBAL &&
+         !(call_flags & (TCG_CALL_NO_READ_GLOBALS |
+                         TCG_CALL_NO_WRITE_GLOBALS)))) {
+        tcg_reg_free(s, reg, allocated_regs);
+        return;
+    }
+
+    set = tcg_target_available_regs[ts->type]
+        & ~tcg_target_call_clobber_regs & ~allocated_regs;
+    for (i = 0; set && i < n; i++) {
+        TCGReg new_reg = tcg_target_reg_alloc_order[i];
+
+        if (s->reg_to_temp[new_reg] == NULL &&
+            tcg_regset_test_reg(set, new_reg) &&
+            tcg_out_mov(s, ts->type, new_reg, reg)) {
+            s->reg_to_temp[reg] = NULL;
+            s->reg_to_temp[new_reg] = ts;
+            ts->reg = new_reg;
+            return;
+        }
+    }
+    tcg_reg_free(s, reg, allocated_regs);
+}
+
 /**
  * tcg_reg_alloc:
  * @required_regs: Set of registers in which we must allocate.
@@ -3958,7 +4003,7 @@ static void tcg_reg_alloc_call(TCGContext *s, TCGOp *op)
     /* clobber call registers */
     for (i = 0; i < TCG_TARGET_NB_REGS; i++) {
         if (tcg_regset_test_reg(tcg_target_call_clobber_regs, i)) {
-            tcg_reg_free(s, i, allocated_regs);
+            tcg_reg_free_for_call(s, i, allocated_regs, flags);
         }
     }
 
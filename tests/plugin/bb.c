@@ -27,6 +27,9 @@ typedef struct {
 static bool do_inline;
 static CPUCount inline_count;
 
+/* Per-cpu counts for system emulation, also updated inline */
+static CPUCount *cpu_counts;
+
 /* Dump running CPU total on idle? */
 static bool idle_report;
 static GPtrArray *counts;
@@ -46,7 +49,7 @@ static void plugin_exit(qemu_plugin_id_t id, void *p)
 {
     g_autoptr(GString) report = g_string_new("");
 
-    if (do_inline || !max_cpus) {
+    if (!max_cpus) {
         g_string_printf(report, "bb's: %" PRIu64", insns: %" PRIu64 "\n",
                         inline_count.bb_count, inline_count.insn_count);
     } else {
@@ -83,7 +86,14 @@ static void vcpu_tb_trans(qemu_plugin_id_t id, struct qemu_plugin_tb *tb)
 {
     size_t n_insns = qemu_plugin_tb_n_insns(tb);
 
-    if (do_inline) {
+    if (do_inline && max_cpus) {
+        qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu(
+            tb, QEMU_PLUGIN_INLINE_ADD_U64,
+            &cpu_counts[0].bb_count, sizeof(CPUCount), 1);
+        qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu(
+            tb, QEMU_PLUGIN_INLINE_ADD_U64,
+            &cpu_counts[0].insn_count, sizeof(CPUCount), n_insns);
+    } else if (do_inline) {
         qemu_plugin_register_vcpu_tb_exec_inline(tb, QEMU_PLUGIN_INLINE_ADD_U64,
                                                  &inline_count.bb_count, 1);
         qemu_plugin_register_vcpu_tb_exec_inline(tb, QEMU_PLUGIN_INLINE_ADD_U64,
@@ -121,11 +131,12 @@ QEMU_PLUGIN_EXPORT int qemu_plugin_install(qemu_plugin_id_t id,
         }
     }
 
-    if (info->system_emulation && !do_inline) {
+    if (info->system_emulation) {
         max_cpus = info->system.max_vcpus;
         counts = g_ptr_array_new();
+        cpu_counts = g_new0(CPUCount, max_cpus);
         for (i = 0; i < max_cpus; i++) {
-            CPUCount *count = g_new0(CPUCount, 1);
+            CPUCount *count = &cpu_counts[i];
             g_mutex_init(&count->lock);
             count->index = i;
             g_ptr_array_add(counts, count);
@@ -54,6 +54,8 @@ static int query_error_class(const char *cmd)
         /* Only valid with accel=tcg */
         { "x-query-jit", ERROR_CLASS_GENERIC_ERROR },
         { "x-query-opcount", ERROR_CLASS_GENERIC_ERROR },
+        /* Only valid with accel=tcg and x-tcg-sampler enabled */
+        { "x-query-tcg-samples", ERROR_CLASS_GENERIC_ERROR },
         { NULL, -1 }
     };
     int i;
@@ -0,0 +1,84 @@
+/*
+ * Concurrent mmap/madvise/munmap from many threads.
+ *
+ * Models the allocator behaviour of multi-threaded runtimes: each
+ * thread repeatedly maps an anonymous chunk, dirties it, hands pages
+ * back with MADV_DONTNEED, issues other hints, and unmaps it again.
+ * MADV_DONTNEED is only a hint under emulation, so just check that the
+ * pages outside the advised range are untouched.  The time taken is
+ * reported to allow comparing thread counts.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ITERATIONS  200
+#define CHUNK_PAGES 16
+
+static size_t page_size;
+
+static void *thread_fn(void *arg)
+{
+    size_t len = CHUNK_PAGES * page_size;
+    int i, j, ret;
+
+    for (i = 0; i < ITERATIONS; i++) {
+        char *p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        assert(p != MAP_FAILED);
+
+        for (j = 0; j < CHUNK_PAGES; j++) {
+            p[j * page_size] = 1;
+        }
+        ret = madvise(p, len, MADV_WILLNEED);
+        assert(ret == 0);
+        ret = madvise(p, len / 2, MADV_DONTNEED);
+        assert(ret == 0);
+        for (j = CHUNK_PAGES / 2; j < CHUNK_PAGES; j++) {
+            assert(p[j * page_size] == 1);
+        }
+        ret = munmap(p, len);
+        assert(ret == 0);
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    int nthreads = 8;
+    struct timespec t0, t1;
+    pthread_t *threads;
+    int i, ret;
+
+    if (argc > 1) {
+        nthreads = atoi(argv[1]);
+    }
+    assert(nthreads > 0);
+    page_size = getpagesize();
+
+    threads = calloc(nthreads, sizeof(pthread_t));
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < nthreads; i++) {
+        ret = pthread_create(&threads[i], NULL, thread_fn, NULL);
+        assert(ret == 0);
+    }
+    for (i = 0; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    printf("%d threads x %d mmap/madvise/munmap in %.3f ms\n",
+           nthreads, ITERATIONS,
+           (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+
+    free(threads);
+    return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * Cold code translation stress test
+ *
+ * Many threads are released at once into a large body of code that has
+ * never run before, so that they all miss in the TB lookup and compete
+ * to translate the same blocks.  The result of every call is checked,
+ * and the time taken is reported to allow comparing thread counts.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define F(n)                                                    \
+    static __attribute__((noinline)) unsigned fn_##n(unsigned x) \
+    {                                                           \
+        if (x & (1u << ((n) & 15))) {                           \
+            x = x * (2 * (n) + 1) + (n);                        \
+        } else {                                                \
+            x = (x >> ((n) & 7)) ^ (n);                         \
+        }                                                       \
+        return x;                                               \
+    }
+#define F4(n)   F(n##0) F(n##1) F(n##2) F(n##3)
+#define F16(n)  F4(n##0) F4(n##1) F4(n##2) F4(n##3)
+#define F64(n)  F16(n##0) F16(n##1) F16(n##2) F16(n##3)
+#define F256(n) F64(n##0) F64(n##1) F64(n##2) F64(n##3)
+
+#define P(n)    fn_##n,
+#define P4(n)   P(n##0) P(n##1) P(n##2) P(n##3)
+#define P16(n)  P4(n##0) P4(n##1) P4(n##2) P4(n##3)
+#define P64(n)  P16(n##0) P16(n##1) P16(n##2) P16(n##3)
+#define P256(n) P64(n##0) P64(n##1) P64(n##2) P64(n##3)
+
+F256(1)
+F256(2)
+
+static unsigned (* const funcs[])(unsigned) = {
+    P256(1)
+    P256(2)
+};
+
+#define NFUNCS  (sizeof(funcs) / sizeof(funcs[0]))
+
+static pthread_barrier_t barrier;
+
+static unsigned run_all(unsigned seed)
+{
+    unsigned x = seed;
+    size_t i;
+
+    for (i = 0; i < NFUNCS; i++) {
+        x = funcs[i](x);
+    }
+    return x;
+}
+
+static void *thread_fn(void *arg)
+{
+    unsigned *result = arg;
+
+    pthread_barrier_wait(&barrier);
+    *result = run_all(1);
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    int nthreads = 16;
+    struct timespec t0, t1;
+    pthread_t *threads;
+    unsigned *results;
+    unsigned expect;
+    int i;
+
+    if (argc > 1) {
+        nthreads = atoi(argv[1]);
+    }
+    assert(nthreads > 0);
+
+    threads = calloc(nthreads, sizeof(pthread_t));
+    results = calloc(nthreads, sizeof(unsigned));
+    pthread_barrier_init(&barrier, NULL, nthreads + 1);
+
+    for (i = 0; i < nthreads; i++) {
+        pthread_create(&threads[i], NULL, thread_fn, &results[i]);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    pthread_barrier_wait(&barrier);
+    for (i = 0; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    /* All code is warm by now. */
+    expect = run_all(1);
+    for (i = 0; i < nthreads; i++) {
+        assert(results[i] == expect);
+    }
+
+    printf("%d threads ran %zu cold functions in %.3f ms\n",
+           nthreads, NFUNCS,
+           (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+
+    pthread_barrier_destroy(&barrier);
+    free(results);
+    free(threads);
+    return 0;
+}